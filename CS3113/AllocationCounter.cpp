@@ -0,0 +1,26 @@
+#include "AllocationCounter.h"
+
+#include <atomic>
+#include <new>
+#include <stdlib.h>
+
+namespace
+{
+    std::atomic<long> gAllocationCount(0);
+}
+
+long getAllocationCount()
+{
+    return gAllocationCount.load(std::memory_order_relaxed);
+}
+
+void *operator new(size_t size)
+{
+    gAllocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void *pointer = malloc(size ? size : 1)) return pointer;
+    throw std::bad_alloc();
+}
+
+void *operator new[](size_t size)               { return operator new(size); }
+void  operator delete(void *pointer) noexcept   { free(pointer); }
+void  operator delete[](void *pointer) noexcept { free(pointer); }
@@ -0,0 +1,13 @@
+#ifndef ALLOCATION_COUNTER_H
+#define ALLOCATION_COUNTER_H
+
+/**
+ * Counts every heap allocation made through `operator new` in the process.
+ *
+ * Linking AllocationCounter.cpp replaces the global `operator new` and
+ * `operator delete`, so it only goes into builds that want the count (the
+ * benchmarks and the game's allocation check), never the shipped game.
+ */
+long getAllocationCount();
+
+#endif // ALLOCATION_COUNTER_H
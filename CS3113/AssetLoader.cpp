@@ -0,0 +1,159 @@
+#include "AssetLoader.h"
+#include "TextureCache.h"
+#include "WorkStealing.h"
+
+AssetLoader::AssetLoader() : mAssetCount{0}, mUploadedCount{0}
+{
+}
+
+AssetLoader::~AssetLoader()
+{
+    if (mCoordinator.joinable()) mCoordinator.join();
+}
+
+/**
+ * Takes textures from the baked blob at `filepath` where it has them.
+ * Call before `start()`.
+ *
+ * @return `false` if there's no usable blob there; everything is then
+ * decoded from its image file as usual.
+ */
+bool AssetLoader::openBaked(const char *filepath)
+{
+    return mBlob.open(filepath);
+}
+
+/**
+ * Adds an image to load. Paths must outlive the loader; only the pointer is
+ * kept. Requests made after `start()` are ignored.
+ */
+void AssetLoader::request(const char *filepath)
+{
+    if (mAssetCount == 0) mRequests.push_back(filepath);
+}
+
+/**
+ * Starts decoding everything requested, in the background, and returns
+ * straight away.
+ *
+ * @param threadCount how many decoding threads to use; 0 uses every
+ * hardware thread but the main one.
+ */
+void AssetLoader::start(int threadCount)
+{
+    if (mRequests.empty() || mAssetCount > 0) return;
+
+    mAssetCount = (int) mRequests.size();
+    mAssets.reset(new Asset[mAssetCount]);
+
+    int bakedCount = 0;
+
+    for (int i = 0; i < mAssetCount; i++)
+    {
+        Asset &asset = mAssets[i];
+        asset.filepath   = mRequests[i];
+        asset.image      = {};
+        asset.isDecoded  = false;
+        asset.isBaked    = false;
+        asset.isUploaded = false;
+        asset.texture    = {};
+
+        // Baked pixels are already in their final form; the image just
+        // borrows them from the mapping
+        const TextureBlobEntry *entry = mBlob.find(asset.filepath);
+        if (entry == nullptr) continue;
+
+        asset.image.data    = (void *) mBlob.getPixels(*entry);
+        asset.image.width   = (int) entry->width;
+        asset.image.height  = (int) entry->height;
+        asset.image.mipmaps = 1;
+        asset.image.format  = (int) entry->format;
+        asset.isBaked       = true;
+        asset.isDecoded     = true;
+        bakedCount++;
+    }
+
+    if (bakedCount == mAssetCount) return;
+
+    if (threadCount <= 0) threadCount = (int) std::thread::hardware_concurrency() - 1;
+    if (threadCount > mAssetCount) threadCount = mAssetCount;
+    if (threadCount < 1) threadCount = 1;
+
+    // The scheduler blocks until every image is decoded, so it gets a thread
+    // of its own and the main thread polls instead
+    Asset *assets = mAssets.get();
+    long   count  = mAssetCount;
+
+    mCoordinator = std::thread([assets, count, threadCount]()
+    {
+        WorkStealingScheduler scheduler;
+        scheduler.run(count, 1, threadCount, [assets](int, long begin, long end)
+        {
+            for (long i = begin; i < end; i++)
+            {
+                if (assets[i].isBaked) continue;
+
+                assets[i].image = LoadImage(assets[i].filepath);
+                assets[i].isDecoded.store(true, std::memory_order_release);
+            }
+        });
+    });
+}
+
+/**
+ * Uploads every image that has finished decoding since the last call, and
+ * frees its CPU copy. Call from the main thread, once per frame while
+ * loading.
+ *
+ * @return how many textures have been uploaded so far, in total.
+ */
+int AssetLoader::uploadReady()
+{
+    for (int i = 0; i < mAssetCount; i++)
+    {
+        Asset &asset = mAssets[i];
+        if (asset.isUploaded || !asset.isDecoded.load(std::memory_order_acquire)) continue;
+
+        // An image that failed to decode is left for `TextureCache` to try
+        // (and report) again when something asks for it
+        if (asset.image.data != nullptr)
+        {
+            Texture2D texture = LoadTextureFromImage(asset.image);
+            if (!asset.isBaked) UnloadImage(asset.image);
+            asset.texture = TextureCache::insert(asset.filepath, texture);
+        }
+
+        asset.image      = {};
+        asset.isUploaded = true;
+        mUploadedCount++;
+    }
+
+    // Once everything is on the GPU the mapping isn't needed
+    if (isDone())
+    {
+        if (mCoordinator.joinable()) mCoordinator.join();
+        mBlob.close();
+    }
+
+    return mUploadedCount;
+}
+
+/**
+ * Drops the loader's references to the textures it loaded. Anything nobody
+ * else acquired in the meantime is unloaded.
+ */
+void AssetLoader::release()
+{
+    if (mCoordinator.joinable()) mCoordinator.join();
+
+    for (int i = 0; i < mAssetCount; i++)
+    {
+        if (mAssets[i].image.data != nullptr && !mAssets[i].isBaked) UnloadImage(mAssets[i].image);
+        if (mAssets[i].texture.id != 0) TextureCache::release(mAssets[i].texture);
+    }
+
+    mAssets.reset();
+    mRequests.clear();
+    mBlob.close();
+    mAssetCount = mUploadedCount = 0;
+}
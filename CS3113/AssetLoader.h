@@ -0,0 +1,67 @@
+#ifndef ASSET_LOADER_H
+#define ASSET_LOADER_H
+
+#include "cs3113.h"
+#include "TextureBlob.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+/**
+ * Loads a set of textures without blocking the main thread on decoding.
+ *
+ * `start()` decodes every requested image (`LoadImage()`: file read plus
+ * PNG decode, no GL) on a pool of worker threads. The main thread calls
+ * `uploadReady()` once per frame, which moves whatever has finished decoding
+ * onto the GPU (GL calls have to stay on the thread that owns the context)
+ * and hands it to `TextureCache`, so later `TextureCache::acquire()` calls
+ * for the same paths return immediately.
+ *
+ * If a baked blob (see `TextureBlob`) was opened first, anything in it skips
+ * decoding entirely: its pixels are uploaded straight from the mapping, and
+ * only what's missing from it goes to the workers.
+ *
+ * The loader keeps one reference to every texture it loaded until
+ * `release()`. Needs a live window from `uploadReady()` on.
+ */
+class AssetLoader
+{
+private:
+    struct Asset
+    {
+        const char       *filepath;
+        Image             image;
+        std::atomic<bool> isDecoded;
+        bool              isBaked;
+        bool              isUploaded;
+        Texture2D         texture;
+    };
+
+    std::unique_ptr<Asset[]>  mAssets;
+    std::vector<const char *> mRequests;
+    int                       mAssetCount;
+    int                       mUploadedCount;
+    std::thread               mCoordinator;
+    TextureBlob               mBlob;
+
+public:
+    AssetLoader();
+    ~AssetLoader();
+
+    AssetLoader(const AssetLoader &) = delete;
+    AssetLoader &operator=(const AssetLoader &) = delete;
+
+    bool openBaked(const char *filepath);
+    void request(const char *filepath);
+    void start(int threadCount = 0);
+    int  uploadReady();
+    void release();
+
+    bool  isDone() const { return mAssetCount > 0 && mUploadedCount == mAssetCount; }
+    float getProgress() const
+        { return mAssetCount > 0 ? (float) mUploadedCount / mAssetCount : 1.0f; }
+};
+
+#endif // ASSET_LOADER_H
@@ -0,0 +1,325 @@
+#include "Broadphase.h"
+
+#include <algorithm>
+#include <math.h>
+
+Broadphase::Broadphase()
+    : mCellSize{1.0f},
+      mOriginX{0.0f},
+      mOriginY{0.0f},
+      mColumns{1},
+      mRows{1},
+      mCellStart(2, 0),
+      mMovingMaxWidth{0.0f},
+      mCurrentStamp{0},
+      mFirstPad{0},
+      mPadCount{0},
+      mIsDirty{true}
+{
+}
+
+int Broadphase::column(float x) const
+{
+    float cell = (x - mOriginX) / mCellSize;
+
+    if (cell < 0.0f)     return 0;
+    if (cell >= mColumns) return mColumns - 1;
+    return (int) cell;
+}
+
+int Broadphase::row(float y) const
+{
+    float cell = (y - mOriginY) / mCellSize;
+
+    if (cell < 0.0f)  return 0;
+    if (cell >= mRows) return mRows - 1;
+    return (int) cell;
+}
+
+void Broadphase::cellRange(const EntityWorld &world, EntityHandle handle,
+    int *minColumn, int *minRow, int *maxColumn, int *maxRow) const
+{
+    float halfWidth  = world.colliderWidth[handle]  / 2.0f;
+    float halfHeight = world.colliderHeight[handle] / 2.0f;
+
+    *minColumn = column(world.positionX[handle] - halfWidth);
+    *maxColumn = column(world.positionX[handle] + halfWidth);
+    *minRow    = row(world.positionY[handle] - halfHeight);
+    *maxRow    = row(world.positionY[handle] + halfHeight);
+}
+
+/**
+ * Re-bins every fixed pad and re-collects the moving ones. Only needed when
+ * pads are added or the world is cleared.
+ *
+ * The cell size is the pads' average extent, so a typical pad lands in one
+ * to four cells; it is doubled until the grid has at most a few cells per
+ * pad, which keeps sparse levels from allocating huge empty grids.
+ */
+void Broadphase::rebuildGrid(const EntityWorld &world, EntityHandle firstPad)
+{
+    const MovingPads &movingPads = world.movingPads;
+    int movingCount = movingPads.size();
+
+    mMovingHandles.assign(movingPads.handle.begin(), movingPads.handle.end());
+    mMovingMinX.resize(movingCount);
+    mMovingIndex.resize(movingCount);
+    mMovingSlot.resize(movingCount);
+    mMovingHalfWidth.resize(movingCount);
+    mMovingMaxWidth = 0.0f;
+
+    for (int k = 0; k < movingCount; k++)
+    {
+        float width = world.colliderWidth[movingPads.handle[k]];
+
+        mMovingIndex[k]     = mMovingSlot[k] = k;
+        mMovingHalfWidth[k] = width / 2.0f;
+        mMovingMaxWidth     = std::max(mMovingMaxWidth, width);
+    }
+
+    float minX =  INFINITY, minY =  INFINITY,
+          maxX = -INFINITY, maxY = -INFINITY;
+    float totalExtent = 0.0f;
+    int   staticCount = 0;
+
+    for (EntityHandle i = firstPad; i < world.size(); i++)
+    {
+        if (world.entityType[i] == MOVING_LANDING_PAD) continue;
+
+        float halfWidth  = world.colliderWidth[i]  / 2.0f;
+        float halfHeight = world.colliderHeight[i] / 2.0f;
+
+        minX = std::min(minX, world.positionX[i] - halfWidth);
+        maxX = std::max(maxX, world.positionX[i] + halfWidth);
+        minY = std::min(minY, world.positionY[i] - halfHeight);
+        maxY = std::max(maxY, world.positionY[i] + halfHeight);
+
+        totalExtent += std::max(world.colliderWidth[i], world.colliderHeight[i]);
+        staticCount++;
+    }
+
+    if (staticCount == 0)
+    {
+        mCellSize = 1.0f;
+        mOriginX  = mOriginY = 0.0f;
+        mColumns  = mRows    = 1;
+    }
+    else
+    {
+        mCellSize = std::max(totalExtent / staticCount, 1.0f);
+        mOriginX  = minX;
+        mOriginY  = minY;
+
+        long maxCells = std::max(64L, 4L * staticCount);
+        for (;;)
+        {
+            mColumns = (int) ((maxX - minX) / mCellSize) + 1;
+            mRows    = (int) ((maxY - minY) / mCellSize) + 1;
+            if ((long) mColumns * mRows <= maxCells) break;
+            mCellSize *= 2.0f;
+        }
+    }
+
+    // Counting sort into cells: count, prefix sum, then scatter. Scattering
+    // walks each cell's start up to the next cell's start, so the offsets
+    // are shifted back down by one cell afterwards.
+    int cellCount = mColumns * mRows;
+    mCellStart.assign(cellCount + 1, 0);
+
+    int minColumn, minRow, maxColumn, maxRow;
+
+    for (EntityHandle i = firstPad; i < world.size(); i++)
+    {
+        if (world.entityType[i] == MOVING_LANDING_PAD) continue;
+
+        cellRange(world, i, &minColumn, &minRow, &maxColumn, &maxRow);
+        for (int r = minRow; r <= maxRow; r++)
+            for (int c = minColumn; c <= maxColumn; c++)
+                mCellStart[r * mColumns + c + 1]++;
+    }
+
+    for (int cell = 0; cell < cellCount; cell++)
+        mCellStart[cell + 1] += mCellStart[cell];
+
+    mCellEntries.resize(mCellStart[cellCount]);
+
+    for (EntityHandle i = firstPad; i < world.size(); i++)
+    {
+        if (world.entityType[i] == MOVING_LANDING_PAD) continue;
+
+        cellRange(world, i, &minColumn, &minRow, &maxColumn, &maxRow);
+        for (int r = minRow; r <= maxRow; r++)
+            for (int c = minColumn; c <= maxColumn; c++)
+                mCellEntries[mCellStart[r * mColumns + c]++] = i;
+    }
+
+    for (int cell = cellCount; cell > 0; cell--)
+        mCellStart[cell] = mCellStart[cell - 1];
+    mCellStart[0] = 0;
+
+    mQueryStamp.assign(world.size(), 0);
+    mCurrentStamp = 0;
+
+    mFirstPad = firstPad;
+    mPadCount = world.size() - firstPad;
+
+    mIsDirty = false;
+}
+
+/**
+ * Refreshes the moving pads' left edges and restores their order. Pads only
+ * move a little per step, so the list is nearly sorted and insertion sort
+ * does close to one pass, shifting nothing for pads still in order.
+ *
+ * Edges are read in `movingPads` order, which is handle order, and written
+ * to each pad's slot in the sweep; read in sweep order they'd be scattered
+ * all over the world's arrays.
+ */
+void Broadphase::sortMovingPads(const EntityWorld &world)
+{
+    int movingCount = (int) mMovingHandles.size();
+
+    const EntityHandle *handle    = world.movingPads.handle.data();
+    const float        *positionX = world.positionX.data();
+
+    for (int k = 0; k < movingCount; k++)
+        mMovingMinX[mMovingSlot[k]] = positionX[handle[k]] - mMovingHalfWidth[k];
+
+    for (int i = 1; i < movingCount; i++)
+    {
+        float minX = mMovingMinX[i];
+        if (mMovingMinX[i - 1] <= minX) continue;
+
+        EntityHandle movingHandle = mMovingHandles[i];
+        int          index        = mMovingIndex[i];
+
+        int j = i - 1;
+        while (j >= 0 && mMovingMinX[j] > minX)
+        {
+            mMovingMinX[j + 1]    = mMovingMinX[j];
+            mMovingHandles[j + 1] = mMovingHandles[j];
+            mMovingIndex[j + 1]   = mMovingIndex[j];
+            mMovingSlot[mMovingIndex[j + 1]] = j + 1;
+            j--;
+        }
+
+        mMovingMinX[j + 1]    = minX;
+        mMovingHandles[j + 1] = movingHandle;
+        mMovingIndex[j + 1]   = index;
+        mMovingSlot[index]    = j + 1;
+    }
+}
+
+/**
+ * Brings the broadphase up to date with the world for this step. Call once
+ * per step, after pads have moved and before `findPairs()`.
+ *
+ * @param world the world being stepped.
+ * @param firstPad the first handle that belongs to a landing pad; everything
+ * from there to the end of the world is treated as a pad.
+ */
+void Broadphase::update(const EntityWorld &world, EntityHandle firstPad)
+{
+    if (mIsDirty) rebuildGrid(world, firstPad);
+
+    if (mPadCount > BRUTE_FORCE_LIMIT) sortMovingPads(world);
+}
+
+void Broadphase::addCandidate(EntityHandle body, EntityHandle other)
+{
+    if (mQueryStamp[other] == mCurrentStamp) return;
+    mQueryStamp[other] = mCurrentStamp;
+
+    mPairs.push_back({ body, other });
+}
+
+/**
+ * Collects every pad that might overlap `body` into the pair list returned by
+ * `getPairs()`. Pairs are only candidates; the caller still runs its own
+ * overlap test on each one.
+ *
+ * The pairs come out ordered by the other entity's handle, so pads get
+ * resolved in the same order as a plain walk over the world would.
+ */
+void Broadphase::findPairs(const EntityWorld &world, EntityHandle body)
+{
+    float halfWidth  = world.colliderWidth[body]  / 2.0f;
+    float halfHeight = world.colliderHeight[body] / 2.0f;
+
+    findPairsInBox(body,
+        world.positionX[body] - halfWidth, world.positionY[body] - halfHeight,
+        world.positionX[body] + halfWidth, world.positionY[body] + halfHeight);
+}
+
+/**
+ * Like `findPairs()`, but for everything `body` could have touched on its way
+ * from `start` to where it is now.
+ *
+ * @param margin extra room around the swept box, to cover how far pads
+ * themselves moved over the same step.
+ */
+void Broadphase::findSweptPairs(const EntityWorld &world, EntityHandle body,
+    Vector2 start, float margin)
+{
+    float halfWidth  = world.colliderWidth[body]  / 2.0f + margin;
+    float halfHeight = world.colliderHeight[body] / 2.0f + margin;
+
+    findPairsInBox(body,
+        std::min(start.x, world.positionX[body]) - halfWidth,
+        std::min(start.y, world.positionY[body]) - halfHeight,
+        std::max(start.x, world.positionX[body]) + halfWidth,
+        std::max(start.y, world.positionY[body]) + halfHeight);
+}
+
+void Broadphase::findPairsInBox(EntityHandle body, float minX, float minY, float maxX, float maxY)
+{
+    mPairs.clear();
+
+    if (mPadCount <= BRUTE_FORCE_LIMIT)
+    {
+        mPairs.resize(mPadCount);
+        for (int i = 0; i < mPadCount; i++) mPairs[i] = { body, mFirstPad + i };
+        return;
+    }
+
+    if (++mCurrentStamp == 0)
+    {
+        std::fill(mQueryStamp.begin(), mQueryStamp.end(), 0);
+        mCurrentStamp = 1;
+    }
+
+    int minColumn = column(minX), maxColumn = column(maxX),
+        minRow    = row(minY),    maxRow    = row(maxY);
+
+    for (int r = minRow; r <= maxRow; r++)
+        for (int c = minColumn; c <= maxColumn; c++)
+        {
+            int cell = r * mColumns + c;
+            for (int k = mCellStart[cell]; k < mCellStart[cell + 1]; k++)
+                addCandidate(body, mCellEntries[k]);
+        }
+
+    // Any mover that reaches our left edge starts at most one mover-width
+    // before it
+    int movingCount = (int) mMovingHandles.size();
+    int first = (int) (std::lower_bound(mMovingMinX.begin(), mMovingMinX.end(),
+        minX - mMovingMaxWidth) - mMovingMinX.begin());
+
+    for (int i = first; i < movingCount && mMovingMinX[i] <= maxX; i++)
+        addCandidate(body, mMovingHandles[i]);
+
+    // A handful of candidates at most, so insertion sort
+    for (size_t i = 1; i < mPairs.size(); i++)
+    {
+        CollisionPair pair = mPairs[i];
+
+        size_t j = i;
+        while (j > 0 && mPairs[j - 1].other > pair.other)
+        {
+            mPairs[j] = mPairs[j - 1];
+            j--;
+        }
+
+        mPairs[j] = pair;
+    }
+}
@@ -1,5 +1,22 @@
 #include "Entity.h"
 
+// Particles per second out of each thruster that's firing. The main engine
+// fires down out of the bottom; the side thrusters fire out of the side
+// opposite the way they push
+constexpr float EXHAUST_RATE = 400.0f;
+
+constexpr ParticleEmitter MAIN_EXHAUST = {
+    { 0.0f, 0.0f }, { 0.0f, 1.0f }, 0.25f,
+    120.0f, 220.0f, 0.25f, 0.6f,
+    3.0f, { 255, 170, 60, 255 }
+};
+
+constexpr ParticleEmitter SIDE_EXHAUST = {
+    { 0.0f, 0.0f }, { 1.0f, 0.0f }, 0.2f,
+    80.0f, 140.0f, 0.15f, 0.35f,
+    2.0f, { 200, 220, 255, 255 }
+};
+
 Entity::Entity(Vector2 position, Vector2 scale, 
     std::vector<const char*> textureFilepaths, TextureType textureType,
     Vector2 spriteSheetDimensions, std::map<RocketState, std::vector<int>> animationAtlas, EntityType entityType) : mPosition {position}, 
@@ -7,153 +24,99 @@ Entity::Entity(Vector2 position, Vector2 scale,
     mTextureType {ATLAS}, 
     mSpriteSheetDimensions {spriteSheetDimensions}, 
     mAnimationAtlas {animationAtlas},
-    mAnimationIndices {animationAtlas.at(IDLE)}, 
     mFrameSpeed {DEFAULT_FRAME_SPEED}, mAngle { 0.0f }, 
     mSpeed { DEFAULT_SPEED }, mRocketStatus { IDLE }, 
     mEntityType { entityType }
 {
     for (int i = 0; i < textureFilepaths.size(); i++)
-        mTextures[(RocketState) i] = LoadTexture(textureFilepaths[i]);
+        mTextures[(RocketState) i] = TextureCache::acquire(textureFilepaths[i]);
 
     mCurrentTexture = mTextures[mRocketStatus];
+
+    compileAnimationClips();
 }
 
 Entity::Entity(Vector2 position, Vector2 scale, const char *textureFilepath, EntityType entityType)
     : mPosition{position},
       mMovement{0.0f, 0.0f},
-      mVelocity{0.0f, 0.0f},
-      mAcceleration{0.0f, 0.0f},
       mScale{scale},
       mColliderDimensions{scale},
       mTextureType{SINGLE},
       mSpriteSheetDimensions{},
       mAnimationAtlas{},
-      mAnimationIndices{},
       mFrameSpeed{0},
       mAngle{0.0f},
       mSpeed{DEFAULT_SPEED - 150},
       mRocketStatus{IDLE}, 
-      mEntityType { entityType },
-      mStartingXPosition{position.x}
-      
+      mEntityType { entityType }
 {
-    mTextures[IDLE]   = LoadTexture(textureFilepath);
+    mTextures[IDLE]   = TextureCache::acquire(textureFilepath);
     mCurrentTexture   = mTextures[IDLE];
+
+    compileAnimationClips();
 }
 
 Entity::~Entity() 
 {
     for (int i = 0; i < mTextures.size(); i++)
-        UnloadTexture(mTextures[(RocketState) i]); 
+        TextureCache::release(mTextures[(RocketState) i]);
 };
 
 /**
- * Iterates through a list of collidable entities, checks for collisions with
- * the player entity, and resolves any vertical overlap by adjusting the 
- * player's position and velocity accordingly.
- * 
- * @param collidableEntities An array of pointers to `Entity` objects that 
- * represent the entities that the current `Entity` instance can potentially
- * collide with. The `collisionCheckCount` parameter specifies the number of
- * entities in the `collidableEntities` array that need to be checked for
- * collision.
- * @param collisionCheckCount The number of entities that the current entity
- * (`Entity`) should check for collisions with. This parameter specifies how
- * many entities are in the `collidableEntities` array that need to be checked
- * for collisions with the current entity.
+ * Turns the animation atlas into ready-to-draw source rectangles, so neither
+ * animating nor rendering has to look anything up or divide anything out
+ * per frame.
+ *
+ * A `SINGLE` texture gets one frame covering the whole image. A state with no
+ * texture or clip of its own borrows `IDLE`'s.
  */
-void Entity::checkCollisionY(Entity *collidableEntities, int collisionCheckCount)
+void Entity::compileAnimationClips()
 {
+    mFrameRectangles.clear();
 
-    for (int i = 0; i < collisionCheckCount; i++)
+    for (int state = 0; state < ROCKET_STATE_COUNT; state++)
     {
-        // STEP 1: For every entity that our player can collide with...
-        Entity *collidableEntity = &collidableEntities[i];
-        
-        if (isColliding(collidableEntity))
-        {
-            // STEP 2: Calculate the distance between its centre and our centre
-            //         and use that to calculate the amount of overlap between
-            //         both bodies.
-            float yDistance = fabs(mPosition.y - collidableEntity->mPosition.y);
-            float yOverlap  = fabs(yDistance - (mColliderDimensions.y / 2.0f) - (collidableEntity->mColliderDimensions.y / 2.0f));
-            
-            // STEP 3: "Unclip" ourselves from the other entity, and zero our
-            //         vertical velocity.
-            if (mVelocity.y > 0) 
-            {
-                mPosition.y -= yOverlap;
-                mVelocity.y  = 0;
-                mIsCollidingBottom = true;
-            } else if (mVelocity.y < 0) 
-            {
-                mPosition.y += yOverlap;
-                mVelocity.y  = 0;
-                mIsCollidingTop = true;
-            }
-        }
-    }
-}
+        std::map<RocketState, Texture2D>::const_iterator texture =
+            mTextures.find((RocketState) state);
+        std::map<RocketState, std::vector<int>>::const_iterator clip =
+            mAnimationAtlas.find((RocketState) state);
 
-void Entity::checkCollisionX(Entity *collidableEntities, int collisionCheckCount)
-{
-    for (int i = 0; i < collisionCheckCount; i++)
-    {
-        Entity *collidableEntity = &collidableEntities[i];
-        
-        if (isColliding(collidableEntity))
-        {            
-            // When standing on a platform, we're always slightly overlapping
-            // it vertically due to gravity, which causes false horizontal
-            // collision detections. So the solution I dound is only resolve X
-            // collisions if there's significant Y overlap, preventing the 
-            // platform we're standing on from acting like a wall.
-            float yDistance = fabs(mPosition.y - collidableEntity->mPosition.y);
-            float yOverlap  = fabs(yDistance - (mColliderDimensions.y / 2.0f) - (collidableEntity->mColliderDimensions.y / 2.0f));
-
-            // Skip if barely touching vertically (standing on platform)
-            if (yOverlap < Y_COLLISION_THRESHOLD) continue;
-
-            float xDistance = fabs(mPosition.x - collidableEntity->mPosition.x);
-            float xOverlap  = fabs(xDistance - (mColliderDimensions.x / 2.0f) - (collidableEntity->mColliderDimensions.x / 2.0f));
-
-            if (mVelocity.x > 0) {
-                mPosition.x     -= xOverlap;
-                mVelocity.x      = 0;
-
-                // Collision!
-                mIsCollidingRight = true;
-            } else if (mVelocity.x < 0) {
-                mPosition.x    += xOverlap;
-                mVelocity.x     = 0;
- 
-                // Collision!
-                mIsCollidingLeft = true;
-            }
+        bool hasTexture = texture != mTextures.end();
+        bool hasClip    = mTextureType == ATLAS && clip != mAnimationAtlas.end() &&
+                          !clip->second.empty();
+
+        if (state != IDLE && (!hasTexture || (mTextureType == ATLAS && !hasClip)))
+        {
+            mStateTextures[state] = mStateTextures[IDLE];
+            mClipStart[state]     = mClipStart[IDLE];
+            mClipLength[state]    = mClipLength[IDLE];
+            continue;
         }
-    }
-}
 
-/**
- * Checks if two entities are colliding based on their positions and collider 
- * dimensions.
- * 
- * @param other represents another Entity with which you want to check for 
- * collision. It is a pointer to the Entity class.
- * 
- * @return returns `true` if the two entities are colliding based on their
- * positions and collider dimensions, and `false` otherwise.
- */
-bool Entity::isColliding(Entity *other) const 
-{
-    float xDistance = fabs(mPosition.x - other->getPosition().x) - 
-        ((mColliderDimensions.x + other->getColliderDimensions().x) / 2.0f);
-    float yDistance = fabs(mPosition.y - other->getPosition().y) - 
-        ((mColliderDimensions.y + other->getColliderDimensions().y) / 2.0f);
+        mStateTextures[state] = hasTexture ? texture->second : Texture2D {};
+        mClipStart[state]     = (int) mFrameRectangles.size();
 
-    if (xDistance < 0.0f && yDistance < 0.0f) return true;
+        if (hasClip)
+        {
+            for (size_t i = 0; i < clip->second.size(); i++)
+                mFrameRectangles.push_back(getUVRectangle(
+                    &mStateTextures[state],
+                    clip->second[i],
+                    mSpriteSheetDimensions.x,
+                    mSpriteSheetDimensions.y
+                ));
+        }
+        else
+        {
+            mFrameRectangles.push_back({
+                0.0f, 0.0f,
+                static_cast<float>(mStateTextures[state].width),
+                static_cast<float>(mStateTextures[state].height)
+            });
+        }
 
-    return false;
+        mClipLength[state] = (int) mFrameRectangles.size() - mClipStart[state];
+    }
 }
 
 /**
@@ -164,9 +127,6 @@ bool Entity::isColliding(Entity *other) const
  */
 void Entity::animate(float deltaTime)
 {
-    // mAnimationIndices = mAnimationAtlas.at(mDirection);
-    mAnimationIndices = mAnimationAtlas.at(mRocketStatus);
-
     mAnimationTime += deltaTime;
     float framesPerSecond = 1.0f / mFrameSpeed;
 
@@ -174,12 +134,11 @@ void Entity::animate(float deltaTime)
     {
         mAnimationTime = 0.0f;
 
-        mCurrentFrameIndex++;
-        mCurrentFrameIndex %= mAnimationIndices.size();
+        if (++mCurrentFrameIndex == mClipLength[mRocketStatus]) mCurrentFrameIndex = 0;
     }
 }
 
-void Entity::displayCollider() 
+void Entity::displayCollider(RenderCommandList *commands) 
 {
     // draw the collision box
     Rectangle colliderBox = {
@@ -189,134 +148,78 @@ void Entity::displayCollider()
         mColliderDimensions.y                        
     };
 
-    DrawRectangleLines(
-        colliderBox.x,      // Top-left X
-        colliderBox.y,      // Top-left Y
-        colliderBox.width,  // Width
-        colliderBox.height, // Height
-        GREEN               // Color
-    );
+    commands->drawRectangleLines(LAYER_DEBUG, colliderBox, GREEN);
 }
 
-void Entity::update(float deltaTime, Entity *collidableEntities[], int collisionCheckCount)
+/**
+ * Advances the entity's animation, and puts out exhaust for whichever
+ * thrusters are firing. Movement is driven by `Simulation`, so the caller
+ * is expected to have already synced the position for this step.
+ *
+ * @param deltaTime represents the time elapsed since the last update.
+ */
+void Entity::update(float deltaTime)
 {
     if  (mEntityStatus == INACTIVE) return;
-    if  (mEntityType != ROCKET)     return;
-    displayStats();
-    if (mIsGameOver) {
-        gameOver();
-    }
-
-    if (!mIsGameOver) {
-        for (int i = 0; i < collisionCheckCount; i++) {
-            checkCollisionY(collidableEntities[i], collisionCheckCount);
-            checkCollisionX(collidableEntities[i], collisionCheckCount);
-        }
-
-        if (mIsCollidingLeft || mIsCollidingRight || mIsCollidingTop) {
-            mGameOverReason = CRASHED;
-            mIsGameOver = true;
-            for (int i = 0; i < collisionCheckCount; i++) collidableEntities[i]->setGameOver();
-        }
 
-        else if (mIsCollidingBottom && fabs(mVelocity.x) <= 5.0f) {
+    PROFILE_SCOPE("animation");
 
-            mGameOverReason = LANDED_SUCCESSFULLY;
-            mIsGameOver = true;
-            for (int i = 0; i < collisionCheckCount; i++) collidableEntities[i]->setGameOver();
-            
-        }
-
-        resetColliderFlags();
-        resetAcceleration();
-
-        if (mAcceleratingUp)    mAcceleration.y -= THRUSTING_ACCELERATION;
-        if (mAcceleratingLeft)  mAcceleration.x -= HORIZONTAL_ACCELERATION;
-        if (mAcceleratingRight) mAcceleration.x += HORIZONTAL_ACCELERATION;
+    if (mTextureType == ATLAS) animate(deltaTime);
 
+    if (mExhaust != nullptr) emitExhaust(deltaTime);
+}
 
-        if (!mAcceleratingLeft && !mAcceleratingRight) 
-        {
-            applyDrag(deltaTime);
-        }
-
-        setRocketState((mAcceleratingUp || mAcceleratingLeft || mAcceleratingRight) ? THRUSTING : IDLE);
+/**
+ * Puts out this frame's share of exhaust from every thruster that's firing,
+ * carrying the fraction of a particle that doesn't fit over to the next
+ * frame so the rate doesn't depend on the frame rate.
+ */
+void Entity::emitExhaust(float deltaTime)
+{
+    if (!mIsThrustingUp && !mIsThrustingLeft && !mIsThrustingRight)
+    {
+        mExhaustTime = 0.0f;
+        return;
+    }
 
-        mAcceleratingRight = mAcceleratingLeft = mAcceleratingUp = false;
+    mExhaustTime += deltaTime;
 
-        mVelocity.x += mAcceleration.x * deltaTime;
-        mVelocity.y += mAcceleration.y * deltaTime;
+    int count = (int) (mExhaustTime * EXHAUST_RATE);
+    if (count == 0) return;
 
-        mPosition.x += mVelocity.x * deltaTime;
-        mPosition.y += mVelocity.y * deltaTime;
-        
+    mExhaustTime -= count / EXHAUST_RATE;
 
-        if (getPosition().y > 850.0f || getPosition().y < -50.0f || 
-            getPosition().x < -50.0f || getPosition().x > 1550.0f) 
-        {
-            mGameOverReason = OUT_OF_BOUNDS;
-            mIsGameOver = true;
-            for (int i = 0; i < collisionCheckCount; i++) collidableEntities[i]->setGameOver();
-        }
+    float halfWidth  = mColliderDimensions.x / 2.0f,
+          halfHeight = mColliderDimensions.y / 2.0f;
 
-        if (mFuelTank <= 0.0f){
-
-            mFuelTank = 0.0f;
-            mGameOverReason = OUT_OF_FUEL;
-            mIsGameOver = true;
-            for (int i = 0; i < collisionCheckCount; i++) collidableEntities[i]->setGameOver();
-        } 
-    
-    if (mTextureType == ATLAS) 
-    
-        animate(deltaTime);
+    if (mIsThrustingUp)
+    {
+        ParticleEmitter emitter = MAIN_EXHAUST;
+        emitter.position = { mPosition.x, mPosition.y + halfHeight };
+        mExhaust->emit(emitter, count);
     }
-}
-
-void Entity::update(float deltaTime) {
 
-    if  (mEntityStatus == INACTIVE) return;
-    if  (mEntityType != MOVING_LANDING_PAD) return;
-    if  (mIsGameOver) return;
-
-    if (mEntityType == MOVING_LANDING_PAD) {
-        mPosition.x += mSpeed * deltaTime;
+    if (mIsThrustingLeft)
+    {
+        ParticleEmitter emitter = SIDE_EXHAUST;
+        emitter.position = { mPosition.x + halfWidth, mPosition.y };
+        mExhaust->emit(emitter, count);
+    }
 
-        if (mPosition.x > mStartingXPosition + 500.0f || mPosition.x < mStartingXPosition - 500.0f) {
-            mSpeed = -mSpeed;
-        }
+    if (mIsThrustingRight)
+    {
+        ParticleEmitter emitter = SIDE_EXHAUST;
+        emitter.position  = { mPosition.x - halfWidth, mPosition.y };
+        emitter.direction = { -1.0f, 0.0f };
+        mExhaust->emit(emitter, count);
     }
 }
 
-void Entity::render()
+void Entity::render(RenderCommandList *commands)
 {
     if(mEntityStatus == INACTIVE) return;
 
-    Rectangle textureArea;
-
-    switch (mTextureType)
-    {
-        case SINGLE:
-            // Whole texture (UV coordinates)
-            textureArea = {
-                // top-left corner
-                0.0f, 0.0f,
-
-                // bottom-right corner (of texture)
-                static_cast<float>(mCurrentTexture.width),
-                static_cast<float>(mCurrentTexture.height)
-            };
-            break;
-        case ATLAS:
-            textureArea = getUVRectangle(
-                &mCurrentTexture, 
-                mAnimationIndices[mCurrentFrameIndex], 
-                mSpriteSheetDimensions.x, 
-                mSpriteSheetDimensions.y
-            );
-        
-        default: break;
-    }
+    const Rectangle &textureArea = mFrameRectangles[mClipStart[mRocketStatus] + mCurrentFrameIndex];
 
     // Destination rectangle – centred on gPosition
     Rectangle destinationArea = {
@@ -332,14 +235,14 @@ void Entity::render()
         static_cast<float>(mScale.y) / 2.0f
     };
 
-    // Render the texture on screen
-    DrawTexturePro(
-        mCurrentTexture, 
+    // Record the sprite; it reaches the screen when the list is submitted
+    commands->drawSprite(
+        LAYER_ENTITIES, mCurrentTexture, 
         textureArea, destinationArea, originOffset,
         mAngle, WHITE
     );
 
-    // displayCollider();
+    // displayCollider(commands);
 }
 
 void Entity::setRocketState(RocketState newState)
@@ -347,43 +250,7 @@ void Entity::setRocketState(RocketState newState)
     if (mRocketStatus == newState) return;
 
         mRocketStatus = newState;
-        mCurrentTexture = mTextures[mRocketStatus];
-        mAnimationIndices = mAnimationAtlas.at(mRocketStatus);
+        mCurrentTexture = mStateTextures[mRocketStatus];
         mCurrentFrameIndex = 0;
         mAnimationTime = 0.0f;
 }
-
-void Entity::displayStats() 
-{
-    float ticks = (float) GetTime();
-    int countdown = 60 - (int)ticks;
-
-
-    DrawText(TextFormat("Fuel: %04.2f%%", mFuelTank), 20, 20, 20, WHITE);
-    DrawText(TextFormat("Altitude: %08.2f", 800 - getPosition().y), 1500 - 300, 20, 20, WHITE);
-    DrawText(TextFormat("Horizontal Speed: %08.2f", getVelocity().x), 1500 - 300, 50, 20, WHITE);
-    DrawText(TextFormat("Vertical Speed: %08.2f", getVelocity().y), 1500 - 300, 80, 20, WHITE);
-}
-
-void Entity::gameOver() 
-{
-    if (mGameOverReason == OUT_OF_BOUNDS) {
-        DrawText("MISSION FAILED: OUT OF BOUNDS", 1500 / 2 - 450, 800 / 2, 50, RED);
-        return;
-    }
-
-    if (mGameOverReason == OUT_OF_FUEL) {
-        DrawText("MISSION FAILED: OUT OF FUEL", 1500 / 2 - 350, 800 / 2, 50, RED);
-        return;
-    }
-
-    if (mGameOverReason == CRASHED) {
-        DrawText("MISSION FAILED: CRASHED", 1500 / 2 - 350, 800 / 2, 50, RED);
-        return;
-    }
-
-    if (mGameOverReason == LANDED_SUCCESSFULLY) {
-        DrawText("MISSION ACCOMPLISHED: LANDED SUCCESSFULLY", 1500 / 2 - 650, 800 / 2, 50, GREEN);
-        return;
-    }
-}
\ No newline at end of file
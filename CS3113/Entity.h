@@ -2,37 +2,43 @@
 #define ENTITY_H
 
 #include "cs3113.h"
+#include "Simulation.h"
+#include "TextureCache.h"
+#include "RenderCommands.h"
+#include "ParticleSystem.h"
+#include "Profiler.h"
 
-enum EntityStatus       { ACTIVE, INACTIVE        };
 enum RocketState        { IDLE, THRUSTING         };
-enum EntityType         { ROCKET, FIXED_LANDING_PAD, MOVING_LANDING_PAD };
-enum GameOverReason     { OUT_OF_BOUNDS, OUT_OF_FUEL, LANDED_SUCCESSFULLY, CRASHED };
-constexpr float         GRAVITATIONAL_ACCELERATION = 10.0f,
-                        THRUSTING_ACCELERATION   = 18.0f,
-                        HORIZONTAL_ACCELERATION = 12.0f,
-                        DRAG_CONSTANT = 0.5f;
-
+constexpr int           ROCKET_STATE_COUNT = 2;
 
+/**
+ * The drawable side of a world object. Physics lives in `Simulation`; an
+ * `Entity` just mirrors the position it is given each frame and owns the
+ * textures and animation state needed to draw it.
+ */
 class Entity
 {
 private:
     Vector2 mPosition;
     Vector2 mMovement;
-    Vector2 mVelocity;
-    Vector2 mAcceleration;
-
-    float mStartingXPosition;
 
     Vector2 mScale;
     Vector2 mColliderDimensions;
-    
+
     std::map<RocketState, Texture2D> mTextures;
     Texture2D mCurrentTexture;
     TextureType mTextureType;
     Vector2 mSpriteSheetDimensions;
-    
+
     std::map<RocketState, std::vector<int>> mAnimationAtlas;
-    std::vector<int> mAnimationIndices;
+
+    // Source rectangles for every clip, back to back, worked out once at
+    // construction. A state's clip is the slice starting at
+    // mClipStart[state] that is mClipLength[state] frames long.
+    std::vector<Rectangle> mFrameRectangles;
+    Texture2D mStateTextures[ROCKET_STATE_COUNT];
+    int mClipStart[ROCKET_STATE_COUNT];
+    int mClipLength[ROCKET_STATE_COUNT];
 
     RocketState mRocketStatus;
     EntityType mEntityType;
@@ -47,112 +53,53 @@ private:
     int mSpeed;
     float mAngle;
 
-    float mFuelTank = 100.0f;
-
-    bool mIsCollidingTop    = false;
-    bool mIsCollidingBottom = false;
-    bool mIsCollidingRight  = false;
-    bool mIsCollidingLeft   = false;
-
-    bool mAcceleratingUp    = false;
-    bool mAcceleratingDown  = false;
-    bool mAcceleratingLeft  = false;
-    bool mAcceleratingRight = false;
-
-    bool mIsGameOver        = false;
-    GameOverReason mGameOverReason;
-
     EntityStatus mEntityStatus = ACTIVE;
 
-    bool isColliding(Entity *other) const;
-    void checkCollisionY(Entity *collidableEntities, int collisionCheckCount);
-    void checkCollisionX(Entity *collidableEntities, int collisionCheckCount);
-    void resetColliderFlags() 
-    {
-        mIsCollidingTop    = false;
-        mIsCollidingBottom = false;
-        mIsCollidingRight  = false;
-        mIsCollidingLeft   = false;
-    }
+    // Where exhaust goes, if anywhere, and which thrusters are firing
+    ParticleSystem *mExhaust = nullptr;
+    bool mIsThrustingUp    = false;
+    bool mIsThrustingLeft  = false;
+    bool mIsThrustingRight = false;
+    float mExhaustTime     = 0.0f;
 
     void animate(float deltaTime);
+    void emitExhaust(float deltaTime);
+    void compileAnimationClips();
 
 public:
     static constexpr int   DEFAULT_SIZE          = 250;
     static constexpr int   DEFAULT_SPEED         = 200;
     static constexpr int   DEFAULT_FRAME_SPEED   = 12;
-    static constexpr float Y_COLLISION_THRESHOLD = 0.5f;
 
     Entity();
 
     Entity(Vector2 position, Vector2 scale, const char *textureFilepath, EntityType entityType);
 
-    Entity(Vector2 position, Vector2 scale, std::vector<const char*> textureFilepaths, 
-        TextureType textureType, Vector2 spriteSheetDimensions, 
+    Entity(Vector2 position, Vector2 scale, std::vector<const char*> textureFilepaths,
+        TextureType textureType, Vector2 spriteSheetDimensions,
         std::map<RocketState, std::vector<int>> animationAtlas, EntityType entityType);
 
     ~Entity();
 
-    void update(float deltaTime, Entity *collidableEntities[], int collisionCheckCount);
     void update(float deltaTime);
-    void render();
+    void render(RenderCommandList *commands);
     void normaliseMovement() { Normalise(&mMovement); }
 
     void jump()       { mIsJumping = true;  }
     void activate()   { mEntityStatus  = ACTIVE;   }
     void deactivate() { mEntityStatus  = INACTIVE; }
-    void displayCollider();
-
-    void displayStats();
+    void displayCollider(RenderCommandList *commands);
 
     bool isActive() { return mEntityStatus == ACTIVE ? true : false; }
 
-    void accelerateUp()    {
-        
-        if (mFuelTank > 0.0f && !mIsGameOver) {
-            mFuelTank -= 0.001f;
-            mAcceleratingUp = true;
-        } 
-       
-     }
-    void accelerateLeft()  {
-        
-        if (mFuelTank > 0.0f && !mIsGameOver) {
-            mFuelTank -= 0.001f;
-            mAcceleratingLeft = true;
-        } 
-
-    }
-    void accelerateRight() {
-
-        if (mFuelTank > 0.0f && !mIsGameOver) {
-            mFuelTank -= 0.001f;
-            mAcceleratingRight = true;
-        } 
-
-    }
-
-    void applyDrag(float deltaTime) {
-
-        float currDrag = -mVelocity.x * DRAG_CONSTANT;     
-        float stoppingAccel = -mVelocity.x / deltaTime;                         
-        if (fabsf(currDrag) > fabsf(stoppingAccel)) currDrag = stoppingAccel;   
-        mAcceleration.x += currDrag;
-
-    }
-
     void resetMovement() { mMovement = { 0.0f, 0.0f }; }
 
-    void resetAcceleration() { setAcceleration({ 0.0f, GRAVITATIONAL_ACCELERATION }); }
-
     Vector2     getPosition()              const { return mPosition;              }
     Vector2     getMovement()              const { return mMovement;              }
-    Vector2     getVelocity()              const { return mVelocity;              }
-    Vector2     getAcceleration()          const { return mAcceleration;          }
     Vector2     getScale()                 const { return mScale;                 }
-    Vector2     getColliderDimensions()    const { return mScale;                 }
+    Vector2     getColliderDimensions()    const { return mColliderDimensions;    }
     Vector2     getSpriteSheetDimensions() const { return mSpriteSheetDimensions; }
-    std::map<RocketState, Texture2D> getTextures()        const { return mTextures;         }
+    const std::map<RocketState, Texture2D> &getTextures() const { return mTextures;       }
     TextureType getTextureType()           const { return mTextureType;           }
 
     int         getFrameSpeed()            const { return mFrameSpeed;            }
@@ -162,23 +109,18 @@ public:
     float       getAngle()                 const { return mAngle;                 }
 
     EntityType  getEntityType()           const { return mEntityType;            }
-    
-    bool isCollidingTop()    const { return mIsCollidingTop;    }
-    bool isCollidingBottom() const { return mIsCollidingBottom; }
 
-    std::map<RocketState, std::vector<int>> getAnimationAtlas() const { return mAnimationAtlas; }
+    const std::map<RocketState, std::vector<int>> &getAnimationAtlas() const { return mAnimationAtlas; }
 
     void setPosition(Vector2 newPosition)
         { mPosition = newPosition;                 }
     void setMovement(Vector2 newMovement)
         { mMovement = newMovement;                 }
-    void setAcceleration(Vector2 newAcceleration)
-        { mAcceleration = newAcceleration;         }
     void setScale(Vector2 newScale)
         { mScale = newScale;                       }
-    void setColliderDimensions(Vector2 newDimensions) 
+    void setColliderDimensions(Vector2 newDimensions)
         { mColliderDimensions = newDimensions;     }
-    void setSpriteSheetDimensions(Vector2 newDimensions) 
+    void setSpriteSheetDimensions(Vector2 newDimensions)
         { mSpriteSheetDimensions = newDimensions;  }
     void setSpeed(int newSpeed)
         { mSpeed  = newSpeed;                      }
@@ -186,12 +128,13 @@ public:
         { mFrameSpeed = newSpeed;                  }
     void setJumpingPower(float newJumpingPower)
         { mJumpingPower = newJumpingPower;         }
-    void setAngle(float newAngle) 
+    void setAngle(float newAngle)
         { mAngle = newAngle;                       }
     void setRocketState(RocketState newState);
-    void setGameOver() { mIsGameOver = true; };
-    
-    void gameOver();
+    void setThrusters(bool up, bool left, bool right)
+        { mIsThrustingUp = up; mIsThrustingLeft = left; mIsThrustingRight = right; }
+    void setExhaust(ParticleSystem *exhaust)
+        { mExhaust = exhaust;                      }
 
 };
 
@@ -0,0 +1,117 @@
+#include "EntityWorld.h"
+
+#include <algorithm>
+
+/**
+ * Appends a new entity at rest to the end of every array. A moving pad also
+ * gets an entry in `movingPads`, anchored where it starts.
+ *
+ * @return the handle of the new entity.
+ */
+EntityHandle EntityWorld::create(EntityType type, Vector2 position,
+    Vector2 colliderDimensions)
+{
+    positionX.push_back(position.x);
+    positionY.push_back(position.y);
+    colliderWidth.push_back(colliderDimensions.x);
+    colliderHeight.push_back(colliderDimensions.y);
+    entityType.push_back((unsigned char) type);
+
+    EntityHandle handle = size() - 1;
+
+    if (type == MOVING_LANDING_PAD)
+    {
+        movingPads.handle.push_back(handle);
+        movingPads.previousX.push_back(position.x);
+        movingPads.velocityX.push_back(0.0f);
+        movingPads.anchorX.push_back(position.x);
+    }
+
+    return handle;
+}
+
+/**
+ * Appends `count` entities at rest in one go, straight from arrays laid out
+ * the same way the world stores them. Each array grows once, rather than
+ * once per entity.
+ *
+ * @return the handle of the first new entity; the rest follow it in order.
+ */
+EntityHandle EntityWorld::createMany(int count, const float *positionsX,
+    const float *positionsY, const float *colliderWidths,
+    const float *colliderHeights, const unsigned char *entityTypes)
+{
+    EntityHandle first = size();
+
+    positionX.insert(positionX.end(), positionsX, positionsX + count);
+    positionY.insert(positionY.end(), positionsY, positionsY + count);
+    colliderWidth.insert(colliderWidth.end(), colliderWidths, colliderWidths + count);
+    colliderHeight.insert(colliderHeight.end(), colliderHeights, colliderHeights + count);
+    entityType.insert(entityType.end(), entityTypes, entityTypes + count);
+
+    for (int i = 0; i < count; i++)
+    {
+        if (entityTypes[i] != MOVING_LANDING_PAD) continue;
+
+        movingPads.handle.push_back(first + i);
+        movingPads.previousX.push_back(positionsX[i]);
+        movingPads.velocityX.push_back(0.0f);
+        movingPads.anchorX.push_back(positionsX[i]);
+    }
+
+    return first;
+}
+
+void EntityWorld::clear()
+{
+    positionX.clear();
+    positionY.clear();
+    colliderWidth.clear();
+    colliderHeight.clear();
+    entityType.clear();
+
+    movingPads.handle.clear();
+    movingPads.previousX.clear();
+    movingPads.velocityX.clear();
+    movingPads.anchorX.clear();
+}
+
+/**
+ * Reserves room for `capacity` bodies. Moving pads are usually a small
+ * fraction of a level, so their arrays are left to grow on their own.
+ */
+void EntityWorld::reserve(int capacity)
+{
+    positionX.reserve(capacity);
+    positionY.reserve(capacity);
+    colliderWidth.reserve(capacity);
+    colliderHeight.reserve(capacity);
+    entityType.reserve(capacity);
+}
+
+/**
+ * Finds a moving pad's entry in `movingPads`. Entries are created in handle
+ * order, so this is a binary search.
+ *
+ * @return the pad's index into `movingPads`, or -1 if `handle` isn't a
+ * moving pad.
+ */
+int EntityWorld::findMovingPad(EntityHandle handle) const
+{
+    std::vector<EntityHandle>::const_iterator found = std::lower_bound(
+        movingPads.handle.begin(), movingPads.handle.end(), handle);
+
+    if (found == movingPads.handle.end() || *found != handle) return -1;
+    return (int) (found - movingPads.handle.begin());
+}
+
+/**
+ * Where a pad was before the last step. Fixed pads never move, so for them
+ * it's where they are now. The rocket keeps its own; see `Simulation`.
+ */
+Vector2 EntityWorld::getPreviousPosition(EntityHandle handle) const
+{
+    if (entityType[handle] != MOVING_LANDING_PAD) return getPosition(handle);
+
+    return { movingPads.previousX[findMovingPad(handle)], positionY[handle] };
+}
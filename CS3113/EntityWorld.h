@@ -0,0 +1,85 @@
+#ifndef ENTITY_WORLD_H
+#define ENTITY_WORLD_H
+
+#include <vector>
+
+// The simulation has to build without raylib, so it only brings its own
+// Vector2 when raylib hasn't already declared one. raylib defines the struct
+// unconditionally, so any file using both must include raylib first (cs3113.h
+// already does this).
+#if !defined(RL_VECTOR2_TYPE)
+typedef struct Vector2 { float x; float y; } Vector2;
+#define RL_VECTOR2_TYPE
+#endif
+
+enum EntityStatus       { ACTIVE, INACTIVE        };
+enum EntityType         { ROCKET, FIXED_LANDING_PAD, MOVING_LANDING_PAD };
+
+typedef int EntityHandle;
+
+/**
+ * The moving pads' own state, one entry per moving pad in the order they were
+ * created. Their positions and extents stay in the world's body arrays
+ * under `handle`, like every other body's; this only adds what a moving pad
+ * has and a fixed one doesn't. Moving pads only ever move sideways, so only
+ * x is tracked.
+ */
+struct MovingPads
+{
+    std::vector<EntityHandle> handle;
+    std::vector<float>        previousX;
+    std::vector<float>        velocityX;
+
+    // Where each pad's patrol is centred
+    std::vector<float>        anchorX;
+
+    int size() const { return (int) handle.size(); }
+};
+
+/**
+ * Every body in the world, stored as parallel arrays rather than one object
+ * per entity. An `EntityHandle` is simply the index into each array, so a
+ * system that only needs, say, positions and extents walks exactly those
+ * arrays front to back.
+ *
+ * A body is only its box and its kind: a fixed pad needs nothing more.
+ * Anything a kind needs beyond that is kept with that kind alone: moving
+ * pads in `movingPads`, the rocket in `Simulation`. Each system then loops
+ * over the one kind it updates, with no per-entity type checks, and a level
+ * of fixed pads costs 17 bytes per pad.
+ *
+ * Handles stay valid until `clear()`; entities are never removed one at a
+ * time.
+ */
+struct EntityWorld
+{
+    std::vector<float> positionX;
+    std::vector<float> positionY;
+    std::vector<float> colliderWidth;
+    std::vector<float> colliderHeight;
+
+    std::vector<unsigned char> entityType;
+
+    MovingPads movingPads;
+
+    EntityHandle create(EntityType type, Vector2 position, Vector2 colliderDimensions);
+    EntityHandle createMany(int count, const float *positionsX, const float *positionsY,
+        const float *colliderWidths, const float *colliderHeights,
+        const unsigned char *entityTypes);
+    void clear();
+    void reserve(int capacity);
+
+    int size() const { return (int) positionX.size(); }
+
+    int findMovingPad(EntityHandle handle) const;
+    Vector2 getPreviousPosition(EntityHandle handle) const;
+
+    Vector2 getPosition(EntityHandle handle) const
+        { return { positionX[handle], positionY[handle] };                 }
+    Vector2 getColliderDimensions(EntityHandle handle) const
+        { return { colliderWidth[handle], colliderHeight[handle] };        }
+    EntityType getEntityType(EntityHandle handle) const
+        { return (EntityType) entityType[handle];                          }
+};
+
+#endif // ENTITY_WORLD_H
@@ -0,0 +1,72 @@
+#include "FramePacer.h"
+#include "Profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+// Lateness is reported in 50 µs buckets; anything from 1.2 ms up shares the
+// last one
+constexpr int64_t LATENESS_BUCKET_NANOSECONDS = 50000;
+
+FramePacer::FramePacer(int framesPerSecond) :
+    mFrameNanoseconds{1000000000 / framesPerSecond},
+    mDeadline{0},
+    mReleaseTime{0},
+    mFrameTime{0},
+    mOversleep{0},
+    mSpin{MIN_SPIN_NANOSECONDS},
+    mMissedCount{0},
+    mLateness{LATENESS_BUCKET_NANOSECONDS}
+{
+}
+
+/**
+ * Starts the grid: the first `wait()` returns one frame from now.
+ */
+void FramePacer::start()
+{
+    mReleaseTime = Profiler::now();
+    mFrameTime   = mFrameNanoseconds;
+    mDeadline    = mReleaseTime + mFrameNanoseconds;
+}
+
+/**
+ * Returns at the end of the current frame, or straight away if it's already
+ * over. Call once per frame, after the frame's work.
+ */
+void FramePacer::wait()
+{
+    int64_t wakeTime = mDeadline - mSpin;
+    int64_t now      = Profiler::now();
+
+    if (now < wakeTime)
+    {
+        std::this_thread::sleep_for(std::chrono::nanoseconds(wakeTime - now));
+        now = Profiler::now();
+
+        // An eighth-weight moving average of the overshoot; spinning for
+        // twice that leaves room for the odd sleep that runs long
+        mOversleep += (now - wakeTime - mOversleep) / 8;
+        mSpin = std::min(std::max(2 * mOversleep, MIN_SPIN_NANOSECONDS), MAX_SPIN_NANOSECONDS);
+    }
+
+    while (now < mDeadline)
+    {
+        std::this_thread::yield();
+        now = Profiler::now();
+    }
+
+    mFrameTime   = now - mReleaseTime;
+    mReleaseTime = now;
+
+    int64_t lateness = now - mDeadline;
+    mLateness.add(lateness);
+
+    if (lateness >= mFrameNanoseconds)
+    {
+        mMissedCount++;
+        mDeadline = now + mFrameNanoseconds;
+    }
+    else mDeadline += mFrameNanoseconds;
+}
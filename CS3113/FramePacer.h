@@ -0,0 +1,57 @@
+#ifndef FRAME_PACER_H
+#define FRAME_PACER_H
+
+#include "Histogram.h"
+
+#include <stdint.h>
+
+/**
+ * Holds frames to a fixed rate without burning a core.
+ *
+ * `wait()` sleeps through most of what's left of the frame, then spins the
+ * last stretch, since sleeps can overshoot by a millisecond or more and a
+ * spin can't. How long that last stretch is adapts to how far sleeps have
+ * actually been overshooting, so a machine with a precise timer spins for
+ * very little of each frame.
+ *
+ * Deadlines are on a fixed grid, so one late frame doesn't push every frame
+ * after it back. A frame that's late by a whole frame or more gives up on
+ * the grid and starts a new one from now rather than rushing to catch up.
+ */
+class FramePacer
+{
+private:
+    // Bounds on the spin; the lower one covers the time it takes to wake
+    static constexpr int64_t MIN_SPIN_NANOSECONDS = 200000,
+                             MAX_SPIN_NANOSECONDS = 4000000;
+
+    int64_t   mFrameNanoseconds;
+    int64_t   mDeadline;
+
+    // When `wait()` last returned, and how long the frame before that ran
+    int64_t   mReleaseTime;
+    int64_t   mFrameTime;
+
+    // Running estimate of how late sleeps wake, and the spin it sets
+    int64_t   mOversleep;
+    int64_t   mSpin;
+
+    long      mMissedCount;
+    Histogram mLateness;
+
+public:
+    explicit FramePacer(int framesPerSecond);
+
+    void start();
+    void wait();
+
+    // Seconds between the last two times `wait()` returned, for whatever
+    // moves with the display rather than the simulation
+    float getFrameSeconds() const { return mFrameTime / 1e9f; }
+
+    // How far after its deadline each frame was let go
+    const Histogram &getLateness()    const { return mLateness;    }
+    long             getMissedCount() const { return mMissedCount; }
+};
+
+#endif // FRAME_PACER_H
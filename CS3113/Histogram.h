@@ -0,0 +1,41 @@
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <stdint.h>
+
+/**
+ * Counts durations in fixed-width buckets, for reporting how something is
+ * distributed rather than just its percentiles. Anything past the last
+ * bucket is counted in it. Fixed size, so adding never allocates.
+ */
+class Histogram
+{
+public:
+    static constexpr int BUCKET_COUNT = 24;
+
+private:
+    int64_t mBucketWidth;
+    long    mBuckets[BUCKET_COUNT];
+    long    mCount;
+    int64_t mMaximum;
+
+public:
+    // Bucket width in nanoseconds
+    explicit Histogram(int64_t bucketWidth) : mBucketWidth{bucketWidth}, mBuckets{}, mCount{0}, mMaximum{0} {}
+
+    void add(int64_t value)
+    {
+        int64_t bucket = value > 0 ? value / mBucketWidth : 0;
+        mBuckets[bucket < BUCKET_COUNT ? bucket : BUCKET_COUNT - 1]++;
+
+        if (value > mMaximum) mMaximum = value;
+        mCount++;
+    }
+
+    int64_t getBucketWidth()        const { return mBucketWidth;    }
+    long    getBucket(int bucket)   const { return mBuckets[bucket]; }
+    long    getCount()              const { return mCount;          }
+    int64_t getMaximum()            const { return mMaximum;        }
+};
+
+#endif // HISTOGRAM_H
@@ -0,0 +1,117 @@
+#include "Hud.h"
+
+#include <stdarg.h>
+#include <string.h>
+
+Hud::Hud() : mLabelCount{0}, mTarget{}, mIsDirty{true}, mRedrawCount{0}
+{
+}
+
+/**
+ * Creates the render texture the labels are cached in.
+ *
+ * @param width,height the size of the area the labels are positioned in,
+ * normally the whole screen.
+ */
+void Hud::load(int width, int height)
+{
+    mTarget  = LoadRenderTexture(width, height);
+    mIsDirty = true;
+}
+
+void Hud::unload()
+{
+    UnloadRenderTexture(mTarget);
+    mTarget = {};
+}
+
+/**
+ * Adds an empty label.
+ *
+ * @return the label's index, for `setText()` and `setColour()`, or -1 if
+ * the HUD is full.
+ */
+int Hud::addLabel(int x, int y, int fontSize, Color colour)
+{
+    if (mLabelCount == MAX_LABELS) return -1;
+
+    Label &label = mLabels[mLabelCount];
+    label.text[0]      = '\0';
+    label.drawnText[0] = '\0';
+    label.colour       = colour;
+    label.drawnColour  = colour;
+    label.x            = x;
+    label.y            = y;
+    label.fontSize     = fontSize;
+
+    return mLabelCount++;
+}
+
+/**
+ * Formats a label's text, `printf`-style, into its buffer. Text longer than
+ * the buffer is cut off. Nothing is redrawn until `refresh()`, and then only
+ * if the formatted text differs from what's on screen.
+ */
+void Hud::setText(int label, const char *format, ...)
+{
+    va_list arguments;
+    va_start(arguments, format);
+    vsnprintf(mLabels[label].text, MAX_TEXT_LENGTH, format, arguments);
+    va_end(arguments);
+
+    if (strcmp(mLabels[label].text, mLabels[label].drawnText) != 0) mIsDirty = true;
+}
+
+void Hud::setColour(int label, Color colour)
+{
+    Label &target = mLabels[label];
+    target.colour = colour;
+
+    if (memcmp(&target.colour, &target.drawnColour, sizeof(Color)) != 0) mIsDirty = true;
+}
+
+/**
+ * Re-rasterises the labels if anything changed since the last refresh.
+ * Call once per frame, before `BeginDrawing()`.
+ */
+void Hud::refresh()
+{
+    if (!mIsDirty) return;
+
+    BeginTextureMode(mTarget);
+    ClearBackground(BLANK);
+
+    for (int i = 0; i < mLabelCount; i++)
+    {
+        Label &label = mLabels[i];
+
+        if (label.text[0] != '\0')
+            DrawText(label.text, label.x, label.y, label.fontSize, label.colour);
+
+        memcpy(label.drawnText, label.text, MAX_TEXT_LENGTH);
+        label.drawnColour = label.colour;
+    }
+
+    EndTextureMode();
+
+    mIsDirty = false;
+    mRedrawCount++;
+}
+
+void Hud::draw(RenderCommandList *commands) const
+{
+    // Render textures come out upside down, so the source is flipped
+    Rectangle source = {
+        0.0f, 0.0f,
+        (float) mTarget.texture.width,
+        (float) -mTarget.texture.height
+    };
+
+    Rectangle destination = {
+        0.0f, 0.0f,
+        (float) mTarget.texture.width,
+        (float) mTarget.texture.height
+    };
+
+    commands->drawSprite(LAYER_HUD, mTarget.texture, source, destination, { 0.0f, 0.0f }, 0.0f, WHITE);
+}
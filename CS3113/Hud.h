@@ -0,0 +1,57 @@
+#ifndef HUD_H
+#define HUD_H
+
+#include "RenderCommands.h"
+
+/**
+ * Screen-space text that is laid out and rasterised only when it changes.
+ *
+ * Each label formats into its own fixed buffer. When any label's text (or
+ * colour) differs from what was last drawn, every label is redrawn into an
+ * offscreen render texture; the rest of the time drawing the HUD is a
+ * single sprite. Values only count as changed once they change at
+ * the precision they're printed at, so a fuel gauge showing two decimals
+ * re-rasterises at most once per hundredth.
+ *
+ * Needs a live window between `load()` and `unload()`.
+ */
+class Hud
+{
+private:
+    static constexpr int MAX_LABELS      = 16;
+    static constexpr int MAX_TEXT_LENGTH = 64;
+
+    struct Label
+    {
+        char  text[MAX_TEXT_LENGTH];
+        char  drawnText[MAX_TEXT_LENGTH];
+        Color colour;
+        Color drawnColour;
+        int   x;
+        int   y;
+        int   fontSize;
+    };
+
+    Label           mLabels[MAX_LABELS];
+    int             mLabelCount;
+    RenderTexture2D mTarget;
+    bool            mIsDirty;
+    int             mRedrawCount;
+
+public:
+    Hud();
+
+    void load(int width, int height);
+    void unload();
+
+    int  addLabel(int x, int y, int fontSize, Color colour);
+    void setText(int label, const char *format, ...);
+    void setColour(int label, Color colour);
+
+    void refresh();
+    void draw(RenderCommandList *commands) const;
+
+    int getRedrawCount() const { return mRedrawCount; }
+};
+
+#endif // HUD_H
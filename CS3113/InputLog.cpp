@@ -0,0 +1,192 @@
+#include "InputLog.h"
+#include "Level.h"
+#include "LanderBatch.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+InputRecorder::InputRecorder()
+{
+    memset(&mHeader, 0, sizeof(mHeader));
+}
+
+/**
+ * Starts a new recording from the simulation's current (freshly loaded)
+ * state, dropping anything recorded before.
+ *
+ * @param timestep the fixed step the run will be stepped with.
+ * @param landingPads the pad count the level was generated with, or 0 for
+ * the stock level.
+ * @param levelSeed the seed the level was generated with, if it was.
+ */
+void InputRecorder::begin(const Simulation &simulation, float timestep,
+    int landingPads, unsigned int levelSeed)
+{
+    Vector2 position = simulation.getRocketPosition();
+    Vector2 velocity = simulation.getRocketVelocity();
+
+    memset(&mHeader, 0, sizeof(mHeader));
+    memcpy(mHeader.magic, INPUT_LOG_MAGIC, sizeof(mHeader.magic));
+    mHeader.version         = INPUT_LOG_VERSION;
+    mHeader.landingPads     = landingPads;
+    mHeader.levelSeed       = levelSeed;
+    mHeader.timestep        = timestep;
+    mHeader.rocketX         = position.x;
+    mHeader.rocketY         = position.y;
+    mHeader.rocketVelocityX = velocity.x;
+    mHeader.rocketVelocityY = velocity.y;
+    mHeader.finalReason     = STILL_FLYING;
+
+    mInputs.clear();
+    mInputs.reserve(RESERVED_STEPS);
+}
+
+/**
+ * Notes the thrusters that are on right now. Call once before every
+ * `Simulation::step()`, after input has been applied.
+ */
+void InputRecorder::record(const Simulation &simulation)
+{
+    const Rocket &rocket = simulation.getRocket();
+
+    mInputs.push_back((unsigned char) (
+        (rocket.acceleratingUp    ? INPUT_UP    : 0) |
+        (rocket.acceleratingLeft  ? INPUT_LEFT  : 0) |
+        (rocket.acceleratingRight ? INPUT_RIGHT : 0)));
+}
+
+/**
+ * Writes the recording to `filepath`, stamped with how the simulation ended
+ * up.
+ *
+ * @return `false` if the file couldn't be written.
+ */
+bool InputRecorder::save(const char *filepath, const Simulation &simulation)
+{
+    Vector2 position = simulation.getRocketPosition();
+
+    mHeader.stepCount   = (uint32_t) mInputs.size();
+    mHeader.finalReason = simulation.isGameOver() ?
+        (int32_t) simulation.getGameOverReason() : STILL_FLYING;
+    mHeader.finalX      = position.x;
+    mHeader.finalY      = position.y;
+
+    FILE *file = fopen(filepath, "wb");
+    if (file == nullptr) return false;
+
+    bool written = fwrite(&mHeader, sizeof(mHeader), 1, file) == 1 &&
+        fwrite(mInputs.data(), 1, mInputs.size(), file) == mInputs.size();
+
+    return fclose(file) == 0 && written;
+}
+
+InputLogReader::InputLogReader() : mData{nullptr}, mSize{0}
+{
+}
+
+InputLogReader::~InputLogReader()
+{
+    close();
+}
+
+/**
+ * Maps the log at `filepath`, replacing whatever was open before.
+ *
+ * @return `false` if the file can't be mapped, isn't an input log, or is
+ * shorter than its header says.
+ */
+bool InputLogReader::open(const char *filepath)
+{
+    close();
+
+    int descriptor = ::open(filepath, O_RDONLY);
+    if (descriptor < 0) return false;
+
+    struct stat status;
+    if (fstat(descriptor, &status) != 0 || (size_t) status.st_size < sizeof(InputLogHeader))
+    {
+        ::close(descriptor);
+        return false;
+    }
+
+    void *mapping = mmap(nullptr, (size_t) status.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    ::close(descriptor);
+
+    if (mapping == MAP_FAILED) return false;
+
+    mData = (const unsigned char *) mapping;
+    mSize = (size_t) status.st_size;
+
+    const InputLogHeader &header = getHeader();
+    if (memcmp(header.magic, INPUT_LOG_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != INPUT_LOG_VERSION ||
+        mSize - sizeof(InputLogHeader) < header.stepCount)
+    {
+        close();
+        return false;
+    }
+
+    // The whole log is read once, front to back
+    madvise(mapping, mSize, MADV_SEQUENTIAL);
+
+    return true;
+}
+
+void InputLogReader::close()
+{
+    if (mData != nullptr) munmap((void *) mData, mSize);
+
+    mData = nullptr;
+    mSize = 0;
+}
+
+/**
+ * Rebuilds the world a log was recorded in, with the rocket where and how
+ * fast it was when recording began.
+ */
+void loadRecordedLevel(Simulation *simulation, const InputLogHeader &header)
+{
+    Vector2 rocketPosition = { header.rocketX, header.rocketY };
+
+    if (header.landingPads > 0) loadRandomLevel(simulation, rocketPosition, header.landingPads, header.levelSeed);
+    else                        loadDefaultLevel(simulation, rocketPosition);
+
+    simulation->setRocketVelocity({ header.rocketVelocityX, header.rocketVelocityY });
+}
+
+/**
+ * Plays a recorded run back from the start, as fast as it will step.
+ *
+ * @return `true` if the replay ended exactly like the recording did: same
+ * game over reason (or still flying) and the same final position, to the
+ * bit.
+ */
+bool replayInputLog(const InputLogReader &log, Simulation *simulation)
+{
+    const InputLogHeader &header = log.getHeader();
+    const unsigned char  *inputs = log.getInputs();
+
+    loadRecordedLevel(simulation, header);
+
+    for (uint32_t i = 0; i < header.stepCount; i++)
+    {
+        simulation->releaseThrusters();
+        if (inputs[i] & INPUT_UP)    simulation->accelerateUp();
+        if (inputs[i] & INPUT_LEFT)  simulation->accelerateLeft();
+        if (inputs[i] & INPUT_RIGHT) simulation->accelerateRight();
+
+        simulation->step(header.timestep);
+    }
+
+    int reason = simulation->isGameOver() ?
+        (int) simulation->getGameOverReason() : STILL_FLYING;
+    Vector2 position = simulation->getRocketPosition();
+
+    return reason == header.finalReason &&
+        memcmp(&position.x, &header.finalX, sizeof(float)) == 0 &&
+        memcmp(&position.y, &header.finalY, sizeof(float)) == 0;
+}
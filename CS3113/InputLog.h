@@ -0,0 +1,102 @@
+#ifndef INPUT_LOG_H
+#define INPUT_LOG_H
+
+#include "Simulation.h"
+
+#include <stdint.h>
+#include <vector>
+
+// One byte per step, holding whichever thrusters were on during it
+constexpr unsigned char INPUT_UP    = 1 << 0,
+                        INPUT_LEFT  = 1 << 1,
+                        INPUT_RIGHT = 1 << 2;
+
+constexpr char     INPUT_LOG_MAGIC[4]  = { 'L', 'L', 'I', 'N' };
+constexpr uint32_t INPUT_LOG_VERSION   = 1;
+
+/**
+ * The fixed-size header at the front of every input log, followed directly
+ * by `stepCount` input bytes. Everything needed to rebuild the starting
+ * world is in here, plus how the recorded run ended so a replay can be
+ * checked against it.
+ *
+ * Written as-is, so logs are only portable between machines with the same
+ * (little-endian, IEEE float) layout, which is all the ones we build for.
+ */
+struct InputLogHeader
+{
+    char     magic[4];
+    uint32_t version;
+    uint32_t stepCount;
+
+    // 0 pads means the stock level; anything else is `loadRandomLevel()`
+    // with this seed
+    int32_t  landingPads;
+    uint32_t levelSeed;
+
+    float    timestep;
+    float    rocketX;
+    float    rocketY;
+    float    rocketVelocityX;
+    float    rocketVelocityY;
+
+    // `STILL_FLYING` if the run was stopped before its game ended
+    int32_t  finalReason;
+    float    finalX;
+    float    finalY;
+};
+
+/**
+ * Collects the thrusters the rocket actually fired on each step of a run,
+ * then writes them out as an input log. Room for ten minutes of 60 Hz steps
+ * is set aside up front, so a recorded game doesn't allocate while it plays.
+ */
+class InputRecorder
+{
+private:
+    static constexpr int RESERVED_STEPS = 60 * 60 * 10;
+
+    InputLogHeader             mHeader;
+    std::vector<unsigned char> mInputs;
+
+public:
+    InputRecorder();
+
+    void begin(const Simulation &simulation, float timestep,
+        int landingPads = 0, unsigned int levelSeed = 0);
+    void record(const Simulation &simulation);
+    bool save(const char *filepath, const Simulation &simulation);
+
+    int getStepCount() const { return (int) mInputs.size(); }
+};
+
+/**
+ * Read-only view of an input log on disk. The file is memory-mapped rather
+ * than read, so opening even a long log costs next to nothing and inputs are
+ * paged in as the replay reaches them.
+ */
+class InputLogReader
+{
+private:
+    const unsigned char *mData;
+    size_t               mSize;
+
+public:
+    InputLogReader();
+    ~InputLogReader();
+
+    InputLogReader(const InputLogReader &) = delete;
+    InputLogReader &operator=(const InputLogReader &) = delete;
+
+    bool open(const char *filepath);
+    void close();
+
+    const InputLogHeader &getHeader() const { return *(const InputLogHeader *) mData; }
+    const unsigned char  *getInputs() const { return mData + sizeof(InputLogHeader); }
+    int                   getStepCount() const { return (int) getHeader().stepCount; }
+};
+
+void loadRecordedLevel(Simulation *simulation, const InputLogHeader &header);
+bool replayInputLog(const InputLogReader &log, Simulation *simulation);
+
+#endif // INPUT_LOG_H
@@ -0,0 +1,233 @@
+#include "LanderBatch.h"
+
+#include <string.h>
+
+LanderBatch::LanderBatch() : mCount{0}, mPaddedCount{0}
+{
+}
+
+/**
+ * Resizes the batch to `count` landers, all at the origin, at rest, with a
+ * full tank and their thrusters off. The padding lanes past `count` start
+ * out already game over, so steps leave them alone.
+ */
+void LanderBatch::reset(int count)
+{
+    mCount       = count;
+    mPaddedCount = (count + LANE_COUNT - 1) / LANE_COUNT * LANE_COUNT;
+
+    AlignedFloats *fields[] = {
+        &mPositionX, &mPositionY, &mVelocityX, &mVelocityY, &mFuelTank,
+        &mThrustUp, &mThrustLeft, &mThrustRight, &mGameOverReason
+    };
+
+    for (AlignedFloats *field : fields)
+    {
+        field->allocate(mPaddedCount, ALIGNMENT);
+        for (int i = 0; i < mPaddedCount; i++) (*field)[i] = 0.0f;
+    }
+
+    for (int i = 0; i < mPaddedCount; i++)
+    {
+        mFuelTank[i]       = STARTING_FUEL;
+        mGameOverReason[i] = i < count ? STILL_FLYING : OUT_OF_BOUNDS;
+    }
+}
+
+void LanderBatch::setLander(int index, Vector2 position, Vector2 velocity)
+{
+    mPositionX[index] = position.x;
+    mPositionY[index] = position.y;
+    mVelocityX[index] = velocity.x;
+    mVelocityY[index] = velocity.y;
+}
+
+/**
+ * Same rules as `Simulation`'s thrusters: held until changed, and ignored
+ * once the lander is out of fuel or its game is over.
+ */
+void LanderBatch::setThrusters(int index, bool up, bool left, bool right)
+{
+    bool canThrust = mFuelTank[index] > 0.0f && !isGameOver(index);
+
+    mThrustUp[index]    = up    && canThrust ? 1.0f : 0.0f;
+    mThrustLeft[index]  = left  && canThrust ? 1.0f : 0.0f;
+    mThrustRight[index] = right && canThrust ? 1.0f : 0.0f;
+}
+
+int LanderBatch::getFlyingCount() const
+{
+    int flying = 0;
+    for (int i = 0; i < mCount; i++) flying += !isGameOver(i);
+    return flying;
+}
+
+/**
+ * Compares every field of every lander, padding included, bit for bit
+ * against `other`, which must be the same size. Bits rather than values, so
+ * a NaN or a -0 that one path produces and the other doesn't still shows.
+ *
+ * @return the first lander that differs in any field, or -1 if none do.
+ */
+int LanderBatch::findMismatch(const LanderBatch &other) const
+{
+    const AlignedFloats *fields[] = {
+        &mPositionX, &mPositionY, &mVelocityX, &mVelocityY, &mFuelTank,
+        &mThrustUp, &mThrustLeft, &mThrustRight, &mGameOverReason
+    };
+    const AlignedFloats *otherFields[] = {
+        &other.mPositionX, &other.mPositionY, &other.mVelocityX, &other.mVelocityY, &other.mFuelTank,
+        &other.mThrustUp, &other.mThrustLeft, &other.mThrustRight, &other.mGameOverReason
+    };
+
+    int first = -1;
+
+    for (size_t field = 0; field < sizeof(fields) / sizeof(fields[0]); field++)
+    {
+        const float *ours   = fields[field]->data(),
+                    *theirs = otherFields[field]->data();
+
+        if (memcmp(ours, theirs, mPaddedCount * sizeof(float)) == 0) continue;
+
+        for (int i = 0; i < mPaddedCount; i++)
+        {
+            if (memcmp(ours + i, theirs + i, sizeof(float)) == 0) continue;
+            if (first < 0 || i < first) first = i;
+            break;
+        }
+    }
+
+    return first;
+}
+
+/**
+ * Runs `integrateLander()` on every lander still flying, one at a time. This
+ * is what `step()` does on builds without a vector instruction set, and the
+ * reference the vector paths are checked against.
+ */
+void LanderBatch::stepScalar(float deltaTime)
+{
+    for (int i = 0; i < mCount; i++)
+    {
+        if (isGameOver(i)) continue;
+
+        if (mFuelTank[i] <= 0.0f) mThrustUp[i] = mThrustLeft[i] = mThrustRight[i] = 0.0f;
+
+        float accelerationX, accelerationY;
+        int reason = integrateLander(deltaTime,
+            mThrustUp[i] != 0.0f, mThrustLeft[i] != 0.0f, mThrustRight[i] != 0.0f,
+            mPositionX[i], mPositionY[i], mVelocityX[i], mVelocityY[i],
+            accelerationX, accelerationY, mFuelTank[i]);
+
+        if (reason != STILL_FLYING) mGameOverReason[i] = (float) reason;
+    }
+}
+
+/**
+ * Advances every lander still flying by one step.
+ *
+ * Each branch of `integrateLander()` becomes a mask: both sides are worked
+ * out for every lane and the mask picks one, and the adds and multiplies
+ * happen in the same order as the scalar code so every lane rounds exactly
+ * as it would there. Lanes whose game is already over are written back
+ * unchanged.
+ */
+void LanderBatch::step(float deltaTime)
+{
+#if defined(__AVX__) || defined(__SSE2__)
+    typedef Lanes::Float Float;
+
+    const Float zero       = Lanes::set(0.0f);
+    const Float one        = Lanes::set(1.0f);
+    const Float signBit    = Lanes::set(-0.0f);
+    const Float timestep   = Lanes::set(deltaTime);
+    const Float gravity    = Lanes::set(GRAVITATIONAL_ACCELERATION);
+    const Float thrust     = Lanes::set(THRUSTING_ACCELERATION);
+    const Float horizontal = Lanes::set(HORIZONTAL_ACCELERATION);
+    const Float drag       = Lanes::set(DRAG_CONSTANT);
+    const Float burnRate   = Lanes::set(FUEL_BURN_RATE);
+    const Float minX       = Lanes::set(WORLD_MIN_X);
+    const Float maxX       = Lanes::set(WORLD_MAX_X);
+    const Float minY       = Lanes::set(WORLD_MIN_Y);
+    const Float maxY       = Lanes::set(WORLD_MAX_Y);
+    const Float outOfBounds = Lanes::set((float) OUT_OF_BOUNDS);
+    const Float outOfFuel   = Lanes::set((float) OUT_OF_FUEL);
+
+    for (int i = 0; i < mPaddedCount; i += Lanes::WIDTH)
+    {
+        Float reason = Lanes::load(mGameOverReason.data() + i);
+        Float flying = Lanes::less(reason, zero);
+        if (Lanes::none(flying)) continue;
+
+        Float fuelTank = Lanes::load(mFuelTank.data() + i);
+        Float empty    = Lanes::lessEqual(fuelTank, zero);
+
+        Float up    = Lanes::andNot(empty, Lanes::notEqual(Lanes::load(mThrustUp.data() + i),    zero));
+        Float left  = Lanes::andNot(empty, Lanes::notEqual(Lanes::load(mThrustLeft.data() + i),  zero));
+        Float right = Lanes::andNot(empty, Lanes::notEqual(Lanes::load(mThrustRight.data() + i), zero));
+
+        Float accelerationX = Lanes::add(Lanes::sub(zero, Lanes::bitAnd(left, horizontal)),
+                                         Lanes::bitAnd(right, horizontal));
+        Float accelerationY = Lanes::sub(gravity, Lanes::bitAnd(up, thrust));
+
+        Float velocityX = Lanes::load(mVelocityX.data() + i);
+        Float velocityY = Lanes::load(mVelocityY.data() + i);
+        Float positionX = Lanes::load(mPositionX.data() + i);
+        Float positionY = Lanes::load(mPositionY.data() + i);
+
+        Float reversed      = Lanes::bitXor(velocityX, signBit);
+        Float currDrag      = Lanes::mul(reversed, drag);
+        Float stoppingAccel = Lanes::div(reversed, timestep);
+        Float overshoots    = Lanes::greater(Lanes::andNot(signBit, currDrag),
+                                             Lanes::andNot(signBit, stoppingAccel));
+        currDrag = Lanes::select(overshoots, stoppingAccel, currDrag);
+
+        // Lanes holding a horizontal thruster add zero, which leaves their
+        // acceleration exactly as it was
+        accelerationX = Lanes::add(accelerationX, Lanes::andNot(Lanes::bitOr(left, right), currDrag));
+
+        Float activeThrusters = Lanes::add(Lanes::add(Lanes::bitAnd(up, one), Lanes::bitAnd(left, one)),
+                                           Lanes::bitAnd(right, one));
+        fuelTank = Lanes::sub(fuelTank, Lanes::mul(Lanes::mul(burnRate, activeThrusters), timestep));
+
+        velocityX = Lanes::add(velocityX, Lanes::mul(accelerationX, timestep));
+        velocityY = Lanes::add(velocityY, Lanes::mul(accelerationY, timestep));
+
+        positionX = Lanes::add(positionX, Lanes::mul(velocityX, timestep));
+        positionY = Lanes::add(positionY, Lanes::mul(velocityY, timestep));
+
+        Float outside = Lanes::bitOr(
+            Lanes::bitOr(Lanes::greater(positionY, maxY), Lanes::less(positionY, minY)),
+            Lanes::bitOr(Lanes::less(positionX, minX),    Lanes::greater(positionX, maxX)));
+
+        Float drained = Lanes::lessEqual(fuelTank, zero);
+        fuelTank = Lanes::andNot(drained, fuelTank);
+
+        Float newReason = Lanes::select(drained, outOfFuel, Lanes::select(outside, outOfBounds, reason));
+
+        Lanes::store(mPositionX.data() + i,   Lanes::select(flying, positionX, Lanes::load(mPositionX.data() + i)));
+        Lanes::store(mPositionY.data() + i,   Lanes::select(flying, positionY, Lanes::load(mPositionY.data() + i)));
+        Lanes::store(mVelocityX.data() + i,   Lanes::select(flying, velocityX, Lanes::load(mVelocityX.data() + i)));
+        Lanes::store(mVelocityY.data() + i,   Lanes::select(flying, velocityY, Lanes::load(mVelocityY.data() + i)));
+        Lanes::store(mFuelTank.data() + i,    Lanes::select(flying, fuelTank,  Lanes::load(mFuelTank.data() + i)));
+        Lanes::store(mGameOverReason.data() + i, Lanes::select(flying, newReason, reason));
+
+        // Running dry releases the thrusters for good, as in `Simulation`
+        Float release = Lanes::bitAnd(flying, empty);
+        Lanes::store(mThrustUp.data() + i,    Lanes::andNot(release, Lanes::load(mThrustUp.data() + i)));
+        Lanes::store(mThrustLeft.data() + i,  Lanes::andNot(release, Lanes::load(mThrustLeft.data() + i)));
+        Lanes::store(mThrustRight.data() + i, Lanes::andNot(release, Lanes::load(mThrustRight.data() + i)));
+    }
+#else
+    stepScalar(deltaTime);
+#endif
+}
+
+const char *LanderBatch::getInstructionSet()
+{
+#if defined(__AVX__) || defined(__SSE2__)
+    return Lanes::name();
+#else
+    return "scalar";
+#endif
+}
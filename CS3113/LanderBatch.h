@@ -0,0 +1,120 @@
+#ifndef LANDER_BATCH_H
+#define LANDER_BATCH_H
+
+#include "Simulation.h"
+#include "Lanes.h"
+
+// Returned by `integrateLander()` while the lander is still in the air
+constexpr int STILL_FLYING = -1;
+
+/**
+ * The free-flight half of a rocket step: thrust and gravity, drag, fuel burn,
+ * integration, then the bounds and fuel checks. This is the scalar reference
+ * that both `Simulation` and `LanderBatch`'s fallback run, and the vector
+ * paths in `LanderBatch` repeat it operation for operation.
+ *
+ * @return the reason the flight ended this step, or `STILL_FLYING`.
+ */
+inline int integrateLander(float deltaTime, bool up, bool left, bool right,
+    float &positionX, float &positionY, float &velocityX, float &velocityY,
+    float &accelerationX, float &accelerationY, float &fuelTank)
+{
+    accelerationX = 0.0f;
+    accelerationY = GRAVITATIONAL_ACCELERATION;
+
+    if (up)    accelerationY -= THRUSTING_ACCELERATION;
+    if (left)  accelerationX -= HORIZONTAL_ACCELERATION;
+    if (right) accelerationX += HORIZONTAL_ACCELERATION;
+
+    if (!left && !right)
+    {
+        // Drag never pushes hard enough to reverse the rocket within a step
+        float currDrag = -velocityX * DRAG_CONSTANT;
+        float stoppingAccel = -velocityX / deltaTime;
+        if (fabsf(currDrag) > fabsf(stoppingAccel)) currDrag = stoppingAccel;
+        accelerationX += currDrag;
+    }
+
+    int activeThrusters = up + left + right;
+    fuelTank -= FUEL_BURN_RATE * activeThrusters * deltaTime;
+
+    velocityX += accelerationX * deltaTime;
+    velocityY += accelerationY * deltaTime;
+
+    positionX += velocityX * deltaTime;
+    positionY += velocityY * deltaTime;
+
+    int reason = STILL_FLYING;
+
+    if (isOutOfBounds(positionX, positionY)) reason = OUT_OF_BOUNDS;
+
+    if (fuelTank <= 0.0f) {
+        fuelTank = 0.0f;
+        reason = OUT_OF_FUEL;
+    }
+
+    return reason;
+}
+
+/**
+ * Many independent landers in free flight, stepped together.
+ *
+ * Each field is one aligned array, padded out to a whole number of vector
+ * lanes, so a step is a single pass over the arrays a full register at a
+ * time: AVX when the build enables it, SSE2 on any other x86-64 build, and
+ * `integrateLander()` one lander at a time everywhere else. All three give
+ * bit-identical results to `Simulation`, as long as nothing contracts the
+ * multiplies and adds into fused ones (the makefile turns that off).
+ *
+ * There are no landing pads here; it covers the part of a rollout where a
+ * lander is nowhere near one, which is nearly all of it.
+ */
+class LanderBatch
+{
+private:
+    int mCount;
+    int mPaddedCount;
+
+    AlignedFloats mPositionX;
+    AlignedFloats mPositionY;
+    AlignedFloats mVelocityX;
+    AlignedFloats mVelocityY;
+    AlignedFloats mFuelTank;
+
+    // Thrusters are 0 or 1, and the game over reason is `STILL_FLYING` or a
+    // `GameOverReason`; both are kept as floats so the vector paths can test
+    // and select them without integer ops, which AVX lacks
+    AlignedFloats mThrustUp;
+    AlignedFloats mThrustLeft;
+    AlignedFloats mThrustRight;
+    AlignedFloats mGameOverReason;
+
+public:
+    static constexpr int    LANE_COUNT = 8;
+    static constexpr size_t ALIGNMENT  = 32;
+
+    LanderBatch();
+
+    void reset(int count);
+    void setLander(int index, Vector2 position, Vector2 velocity);
+    void setFuelTank(int index, float fuelTank) { mFuelTank[index] = fuelTank; }
+    void setThrusters(int index, bool up, bool left, bool right);
+
+    void step(float deltaTime);
+    void stepScalar(float deltaTime);
+
+    int  size()                       const { return mCount; }
+    int  getFlyingCount()             const;
+    int  findMismatch(const LanderBatch &other) const;
+    bool isGameOver(int index)        const { return mGameOverReason[index] != STILL_FLYING; }
+
+    GameOverReason getGameOverReason(int index) const
+        { return (GameOverReason) (int) mGameOverReason[index]; }
+    Vector2 getPosition(int index)    const { return { mPositionX[index], mPositionY[index] }; }
+    Vector2 getVelocity(int index)    const { return { mVelocityX[index], mVelocityY[index] }; }
+    float   getFuelTank(int index)    const { return mFuelTank[index]; }
+
+    static const char *getInstructionSet();
+};
+
+#endif // LANDER_BATCH_H
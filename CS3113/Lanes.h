@@ -0,0 +1,114 @@
+#ifndef LANES_H
+#define LANES_H
+
+#include <memory>
+#include <stdint.h>
+#include <stddef.h>
+
+#if defined(__AVX__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+/**
+ * The widest float vector the build enables, as a handful of operations
+ * under one name, so batch code is written once and compiles to AVX or
+ * SSE2. Builds with neither get no `Lanes` at all and fall back to their
+ * scalar paths.
+ */
+#if defined(__AVX__)
+struct Lanes
+{
+    typedef __m256 Float;
+    static constexpr int WIDTH = 8;
+
+    static Float load(const float *p)     { return _mm256_load_ps(p);     }
+    static void  store(float *p, Float a) { _mm256_store_ps(p, a);        }
+    static Float set(float a)             { return _mm256_set1_ps(a);     }
+
+    static Float add(Float a, Float b)    { return _mm256_add_ps(a, b);   }
+    static Float sub(Float a, Float b)    { return _mm256_sub_ps(a, b);   }
+    static Float mul(Float a, Float b)    { return _mm256_mul_ps(a, b);   }
+    static Float div(Float a, Float b)    { return _mm256_div_ps(a, b);   }
+
+    static Float bitAnd(Float a, Float b) { return _mm256_and_ps(a, b);   }
+    static Float bitOr(Float a, Float b)  { return _mm256_or_ps(a, b);    }
+    static Float bitXor(Float a, Float b) { return _mm256_xor_ps(a, b);   }
+    static Float andNot(Float a, Float b) { return _mm256_andnot_ps(a, b); }
+
+    static Float less(Float a, Float b)      { return _mm256_cmp_ps(a, b, _CMP_LT_OQ);  }
+    static Float lessEqual(Float a, Float b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ);  }
+    static Float greater(Float a, Float b)   { return _mm256_cmp_ps(a, b, _CMP_GT_OQ);  }
+    static Float notEqual(Float a, Float b)  { return _mm256_cmp_ps(a, b, _CMP_NEQ_UQ); }
+    static bool  none(Float mask)            { return _mm256_movemask_ps(mask) == 0;    }
+
+    // Picks `a` where the mask is set and `b` elsewhere
+    static Float select(Float mask, Float a, Float b) { return bitOr(bitAnd(mask, a), andNot(mask, b)); }
+
+    static const char *name() { return "AVX"; }
+};
+#elif defined(__SSE2__)
+struct Lanes
+{
+    typedef __m128 Float;
+    static constexpr int WIDTH = 4;
+
+    static Float load(const float *p)     { return _mm_load_ps(p);     }
+    static void  store(float *p, Float a) { _mm_store_ps(p, a);        }
+    static Float set(float a)             { return _mm_set1_ps(a);     }
+
+    static Float add(Float a, Float b)    { return _mm_add_ps(a, b);   }
+    static Float sub(Float a, Float b)    { return _mm_sub_ps(a, b);   }
+    static Float mul(Float a, Float b)    { return _mm_mul_ps(a, b);   }
+    static Float div(Float a, Float b)    { return _mm_div_ps(a, b);   }
+
+    static Float bitAnd(Float a, Float b) { return _mm_and_ps(a, b);   }
+    static Float bitOr(Float a, Float b)  { return _mm_or_ps(a, b);    }
+    static Float bitXor(Float a, Float b) { return _mm_xor_ps(a, b);   }
+    static Float andNot(Float a, Float b) { return _mm_andnot_ps(a, b); }
+
+    static Float less(Float a, Float b)      { return _mm_cmplt_ps(a, b);  }
+    static Float lessEqual(Float a, Float b) { return _mm_cmple_ps(a, b);  }
+    static Float greater(Float a, Float b)   { return _mm_cmpgt_ps(a, b);  }
+    static Float notEqual(Float a, Float b)  { return _mm_cmpneq_ps(a, b); }
+    static bool  none(Float mask)            { return _mm_movemask_ps(mask) == 0; }
+
+    // Picks `a` where the mask is set and `b` elsewhere
+    static Float select(Float mask, Float a, Float b) { return bitOr(bitAnd(mask, a), andNot(mask, b)); }
+
+    static const char *name() { return "SSE2"; }
+};
+#endif
+
+/**
+ * A float array whose storage starts on a given boundary, so the vector
+ * paths can use aligned loads and stores.
+ */
+class AlignedFloats
+{
+private:
+    std::unique_ptr<unsigned char[]> mStorage;
+    float *mData;
+    int    mCapacity;
+
+public:
+    AlignedFloats() : mData{nullptr}, mCapacity{0} {}
+
+    // Keeps the current storage if it's already big enough
+    void allocate(int count, size_t alignment)
+    {
+        if (count <= mCapacity) return;
+        mCapacity = count;
+
+        mStorage.reset(new unsigned char[count * sizeof(float) + alignment]);
+        uintptr_t address = (uintptr_t) mStorage.get();
+        mData = (float *) ((address + alignment - 1) & ~(uintptr_t) (alignment - 1));
+    }
+
+    float       *data()       { return mData; }
+    const float *data() const { return mData; }
+
+    float       &operator[](int i)       { return mData[i]; }
+    const float &operator[](int i) const { return mData[i]; }
+};
+
+#endif // LANES_H
@@ -0,0 +1,131 @@
+#include "Level.h"
+#include "Random.h"
+
+/**
+ * Builds the stock lunar lander layout: five pads, one of them moving, with
+ * the rocket dropped in at the given position.
+ *
+ * @param simulation the world to fill in; it is reset first.
+ * @param rocketPosition where the rocket starts.
+ */
+void loadDefaultLevel(Simulation *simulation, Vector2 rocketPosition)
+{
+    simulation->reset();
+    simulation->setRocket(rocketPosition, ROCKET_COLLIDER);
+
+    simulation->addLandingPad(
+        LANDING_PAD_POSITION,
+        LANDING_PAD_SCALE,
+        FIXED_LANDING_PAD
+    );
+
+    simulation->addLandingPad(
+        { LANDING_PAD_POSITION.x + 500, LANDING_PAD_POSITION.y },
+        LANDING_PAD_SCALE,
+        MOVING_LANDING_PAD
+    );
+
+    simulation->addLandingPad(
+        { LANDING_PAD_POSITION.x + 1000, LANDING_PAD_POSITION.y },
+        LANDING_PAD_SCALE,
+        FIXED_LANDING_PAD
+    );
+
+    simulation->addLandingPad(
+        { LANDING_PAD_POSITION.x, LANDING_PAD_POSITION.y - 400 },
+        LANDING_PAD_SCALE,
+        FIXED_LANDING_PAD
+    );
+
+    simulation->addLandingPad(
+        { LANDING_PAD_POSITION.x + 1000, LANDING_PAD_POSITION.y - 300 },
+        LANDING_PAD_SCALE,
+        FIXED_LANDING_PAD
+    );
+}
+
+/**
+ * Scatters pads over a square that grows with the pad count, keeping roughly
+ * the stock level's density (five pads per screen). About one pad in ten
+ * moves. Nothing is placed right around the rocket's starting position.
+ *
+ * @param simulation the world to fill in; it is reset first.
+ * @param rocketPosition where the rocket starts.
+ * @param landingPadCount how many pads to generate.
+ * @param seed the same seed always generates the same level.
+ */
+void loadRandomLevel(Simulation *simulation, Vector2 rocketPosition,
+    int landingPadCount, unsigned int seed)
+{
+    constexpr float AREA_PER_PAD = 1500.0f * 800.0f / 5.0f,
+                    SPAWN_CLEARANCE = 150.0f;
+
+    Random random(seed);
+
+    simulation->reset();
+    simulation->reserve(landingPadCount + 1);
+    simulation->setRocket(rocketPosition, ROCKET_COLLIDER);
+
+    float side = sqrtf(landingPadCount * AREA_PER_PAD);
+    float left = ROCKET_STARTING_POSITION.x - side / 2.0f,
+          top  = ROCKET_STARTING_POSITION.y - side / 2.0f;
+
+    int created = 0;
+    while (created < landingPadCount)
+    {
+        Vector2 position = {
+            random.nextFloat(left, left + side),
+            random.nextFloat(top,  top  + side)
+        };
+        Vector2 colliderDimensions = {
+            random.nextFloat(100.0f, LANDING_PAD_SCALE.x),
+            LANDING_PAD_SCALE.y
+        };
+
+        if (fabsf(position.x - rocketPosition.x) < colliderDimensions.x / 2.0f + SPAWN_CLEARANCE &&
+            fabsf(position.y - rocketPosition.y) < colliderDimensions.y / 2.0f + SPAWN_CLEARANCE)
+            continue;
+
+        simulation->addLandingPad(
+            position,
+            colliderDimensions,
+            random.next() % 10 == 0 ? MOVING_LANDING_PAD : FIXED_LANDING_PAD
+        );
+        created++;
+    }
+}
+
+/**
+ * Gives an already loaded level a terrain across the whole world, and
+ * flattens it under every fixed pad low enough to reach it, so those pads
+ * sit in the surface rather than on a slope. Moving pads and pads above the
+ * hills are left in the air.
+ *
+ * @param seed the same seed always generates the same surface.
+ * @param baseY the height the surface rolls around.
+ * @param amplitude how far above or below `baseY` it can go.
+ * @param spacing how far apart its samples are.
+ */
+void addTerrain(Simulation *simulation, unsigned int seed, float baseY, float amplitude,
+    float spacing)
+{
+    Terrain terrain;
+    terrain.generate(seed, WORLD_MIN_X, WORLD_MAX_X, spacing, baseY, amplitude);
+
+    const EntityWorld &world = simulation->getWorld();
+
+    for (EntityHandle i = ROCKET_HANDLE + 1; i < world.size(); i++)
+    {
+        if (world.entityType[i] != FIXED_LANDING_PAD) continue;
+
+        float bottom    = world.positionY[i] + world.colliderHeight[i] / 2.0f,
+              halfWidth = world.colliderWidth[i] / 2.0f;
+
+        if (bottom < baseY - amplitude) continue;
+
+        terrain.flatten(world.positionX[i] - halfWidth, world.positionX[i] + halfWidth,
+            bottom, TERRAIN_SHOULDER);
+    }
+
+    simulation->setTerrain(terrain);
+}
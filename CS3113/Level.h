@@ -0,0 +1,24 @@
+#ifndef LEVEL_H
+#define LEVEL_H
+
+#include "Simulation.h"
+
+constexpr Vector2 ROCKET_STARTING_POSITION = { 750.0f, 400.0f },
+                  ROCKET_SCALE             = { 100.0f, 100.0f },
+                  ROCKET_COLLIDER          = { 50.0f,  50.0f  },
+
+                  LANDING_PAD_POSITION     = { 250.0f, 600.0f },
+                  LANDING_PAD_SCALE        = { 500.0f, 30.0f  };
+
+// Terrain is sampled every few pixels, and eases back from the flat under a
+// pad over about half a rocket's width
+constexpr float   TERRAIN_SPACING          = 4.0f,
+                  TERRAIN_SHOULDER         = 24.0f;
+
+void loadDefaultLevel(Simulation *simulation, Vector2 rocketPosition);
+void loadRandomLevel(Simulation *simulation, Vector2 rocketPosition,
+    int landingPadCount, unsigned int seed);
+void addTerrain(Simulation *simulation, unsigned int seed, float baseY, float amplitude,
+    float spacing = TERRAIN_SPACING);
+
+#endif // LEVEL_H
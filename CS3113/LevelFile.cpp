@@ -0,0 +1,274 @@
+#include "LevelFile.h"
+#include "Level.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+    // A level's pads, parallel arrays in compiled-file order
+    struct LevelSource
+    {
+        Vector2                    rocketPosition = ROCKET_STARTING_POSITION;
+        std::vector<float>         positionsX;
+        std::vector<float>         positionsY;
+        std::vector<float>         colliderWidths;
+        std::vector<float>         colliderHeights;
+        std::vector<unsigned char> entityTypes;
+
+        bool                       hasTerrain = false;
+        unsigned int               terrainSeed = 0;
+        float                      terrainBaseY = 0.0f;
+        float                      terrainAmplitude = 0.0f;
+    };
+
+    /**
+     * Parses a text level. Problems are reported on stderr with their line
+     * number.
+     */
+    bool parseLevelSource(const char *filepath, LevelSource *source)
+    {
+        FILE *file = fopen(filepath, "r");
+        if (file == nullptr)
+        {
+            fprintf(stderr, "%s: could not open\n", filepath);
+            return false;
+        }
+
+        char line[256];
+        int  lineNumber = 0;
+        bool isValid    = true;
+
+        while (isValid && fgets(line, sizeof(line), file) != nullptr)
+        {
+            lineNumber++;
+
+            char         keyword[16], kind[16];
+            float        x, y, width, height;
+            unsigned int seed;
+
+            if (sscanf(line, " %15s", keyword) != 1 || keyword[0] == '#') continue;
+
+            if (strcmp(keyword, "rocket") == 0 &&
+                sscanf(line, " rocket %f %f", &x, &y) == 2)
+            {
+                source->rocketPosition = { x, y };
+            }
+            else if (strcmp(keyword, "pad") == 0 &&
+                sscanf(line, " pad %15s %f %f %f %f", kind, &x, &y, &width, &height) == 5 &&
+                (strcmp(kind, "fixed") == 0 || strcmp(kind, "moving") == 0))
+            {
+                source->positionsX.push_back(x);
+                source->positionsY.push_back(y);
+                source->colliderWidths.push_back(width);
+                source->colliderHeights.push_back(height);
+                source->entityTypes.push_back((unsigned char)
+                    (strcmp(kind, "moving") == 0 ? MOVING_LANDING_PAD : FIXED_LANDING_PAD));
+            }
+            else if (strcmp(keyword, "terrain") == 0 &&
+                sscanf(line, " terrain %u %f %f", &seed, &y, &height) == 3)
+            {
+                source->hasTerrain       = true;
+                source->terrainSeed      = seed;
+                source->terrainBaseY     = y;
+                source->terrainAmplitude = height;
+            }
+            else
+            {
+                fprintf(stderr, "%s:%d: expected 'rocket <x> <y>', "
+                    "'pad fixed|moving <x> <y> <width> <height>' or "
+                    "'terrain <seed> <baseY> <amplitude>'\n", filepath, lineNumber);
+                isValid = false;
+            }
+        }
+
+        fclose(file);
+        return isValid;
+    }
+}
+
+CompiledLevel::CompiledLevel() : mData{nullptr}, mSize{0}
+{
+}
+
+CompiledLevel::~CompiledLevel()
+{
+    close();
+}
+
+/**
+ * Maps the compiled level at `filepath`, replacing whatever was open before.
+ *
+ * @return `false` if the file can't be mapped, isn't a compiled level, or is
+ * shorter than its header says.
+ */
+bool CompiledLevel::open(const char *filepath)
+{
+    close();
+
+    int descriptor = ::open(filepath, O_RDONLY);
+    if (descriptor < 0) return false;
+
+    struct stat status;
+    if (fstat(descriptor, &status) != 0 || (size_t) status.st_size < sizeof(CompiledLevelHeader))
+    {
+        ::close(descriptor);
+        return false;
+    }
+
+    void *mapping = mmap(nullptr, (size_t) status.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    ::close(descriptor);
+
+    if (mapping == MAP_FAILED) return false;
+
+    mData = (const unsigned char *) mapping;
+    mSize = (size_t) status.st_size;
+
+    const CompiledLevelHeader &header = getHeader();
+    size_t padBytes = (size_t) header.landingPadCount * (4 * sizeof(float) + 1);
+
+    if (memcmp(header.magic, COMPILED_LEVEL_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != COMPILED_LEVEL_VERSION ||
+        mSize - sizeof(CompiledLevelHeader) < padBytes)
+    {
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+void CompiledLevel::close()
+{
+    if (mData != nullptr) munmap((void *) mData, mSize);
+
+    mData = nullptr;
+    mSize = 0;
+}
+
+/**
+ * Resets the simulation and fills it with a compiled level: the rocket at
+ * the level's start, then every pad in one bulk copy, then its terrain if
+ * it has one.
+ */
+void loadCompiledLevel(Simulation *simulation, const CompiledLevel &level)
+{
+    const CompiledLevelHeader &header = level.getHeader();
+    int count = level.getLandingPadCount();
+
+    simulation->reset();
+    simulation->reserve(count + 1);
+    simulation->setRocket({ header.rocketX, header.rocketY }, ROCKET_COLLIDER);
+    simulation->addLandingPads(count, level.getPositionsX(), level.getPositionsY(),
+        level.getColliderWidths(), level.getColliderHeights(), level.getEntityTypes());
+
+    if (header.flags & COMPILED_LEVEL_HAS_TERRAIN)
+        addTerrain(simulation, header.terrainSeed, header.terrainBaseY, header.terrainAmplitude);
+}
+
+/**
+ * Loads a level from either form, telling them apart by the compiled form's
+ * magic number.
+ *
+ * @return `false` if the file couldn't be read or parsed; the simulation is
+ * left as it was.
+ */
+bool loadLevelFile(Simulation *simulation, const char *filepath)
+{
+    CompiledLevel compiled;
+    if (compiled.open(filepath))
+    {
+        loadCompiledLevel(simulation, compiled);
+        return true;
+    }
+
+    LevelSource source;
+    if (!parseLevelSource(filepath, &source)) return false;
+
+    int count = (int) source.positionsX.size();
+
+    simulation->reset();
+    simulation->reserve(count + 1);
+    simulation->setRocket(source.rocketPosition, ROCKET_COLLIDER);
+    simulation->addLandingPads(count, source.positionsX.data(), source.positionsY.data(),
+        source.colliderWidths.data(), source.colliderHeights.data(), source.entityTypes.data());
+
+    if (source.hasTerrain)
+        addTerrain(simulation, source.terrainSeed, source.terrainBaseY, source.terrainAmplitude);
+
+    return true;
+}
+
+/**
+ * Compiles a text level into the binary form.
+ *
+ * @return `false` if the source didn't parse or the output couldn't be
+ * written.
+ */
+bool compileLevel(const char *sourcePath, const char *compiledPath)
+{
+    LevelSource source;
+    if (!parseLevelSource(sourcePath, &source)) return false;
+
+    CompiledLevelHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, COMPILED_LEVEL_MAGIC, sizeof(header.magic));
+    header.version         = COMPILED_LEVEL_VERSION;
+    header.landingPadCount = (uint32_t) source.positionsX.size();
+    header.rocketX         = source.rocketPosition.x;
+    header.rocketY         = source.rocketPosition.y;
+
+    if (source.hasTerrain)
+    {
+        header.flags            = COMPILED_LEVEL_HAS_TERRAIN;
+        header.terrainSeed      = source.terrainSeed;
+        header.terrainBaseY     = source.terrainBaseY;
+        header.terrainAmplitude = source.terrainAmplitude;
+    }
+
+    FILE *file = fopen(compiledPath, "wb");
+    if (file == nullptr) return false;
+
+    size_t count = source.positionsX.size();
+    bool written = fwrite(&header, sizeof(header), 1, file) == 1 &&
+        fwrite(source.positionsX.data(),      sizeof(float), count, file) == count &&
+        fwrite(source.positionsY.data(),      sizeof(float), count, file) == count &&
+        fwrite(source.colliderWidths.data(),  sizeof(float), count, file) == count &&
+        fwrite(source.colliderHeights.data(), sizeof(float), count, file) == count &&
+        fwrite(source.entityTypes.data(),     1,             count, file) == count;
+
+    return fclose(file) == 0 && written;
+}
+
+/**
+ * Writes the simulation's current layout (rocket start, every pad where it
+ * is now, and the terrain) out as a text level, so generated levels can be edited and
+ * compiled like hand-written ones.
+ */
+bool writeLevelSource(const Simulation &simulation, const char *filepath)
+{
+    FILE *file = fopen(filepath, "w");
+    if (file == nullptr) return false;
+
+    const EntityWorld &world = simulation.getWorld();
+
+    fprintf(file, "rocket %.9g %.9g\n", world.positionX[ROCKET_HANDLE], world.positionY[ROCKET_HANDLE]);
+
+    for (EntityHandle i = ROCKET_HANDLE + 1; i < world.size(); i++)
+    {
+        fprintf(file, "pad %-6s %.9g %.9g %.9g %.9g\n",
+            world.entityType[i] == MOVING_LANDING_PAD ? "moving" : "fixed",
+            world.positionX[i], world.positionY[i], world.colliderWidth[i], world.colliderHeight[i]);
+    }
+
+    const Terrain &terrain = simulation.getTerrain();
+    if (!terrain.isEmpty())
+        fprintf(file, "terrain %u %.9g %.9g\n", terrain.getSeed(), terrain.getBaseY(), terrain.getAmplitude());
+
+    return fclose(file) == 0;
+}
@@ -0,0 +1,85 @@
+#ifndef LEVEL_FILE_H
+#define LEVEL_FILE_H
+
+#include "Simulation.h"
+
+#include <stdint.h>
+
+constexpr char     COMPILED_LEVEL_MAGIC[4] = { 'L', 'L', 'L', 'V' };
+constexpr uint32_t COMPILED_LEVEL_VERSION  = 2;
+
+// Set in a compiled level's flags when it has a terrain
+constexpr uint32_t COMPILED_LEVEL_HAS_TERRAIN = 1;
+
+/**
+ * Levels are written by hand as text, one item per line:
+ *
+ *     # comments and blank lines are ignored
+ *     rocket <x> <y>
+ *     pad fixed  <x> <y> <width> <height>
+ *     pad moving <x> <y> <width> <height>
+ *     terrain <seed> <baseY> <amplitude>
+ *
+ * and compiled into a binary form that loads without any parsing. The
+ * compiled file is this header followed by the pads as parallel arrays, in
+ * the same layout `EntityWorld` keeps them in: every x position, then every
+ * y position, every width, every height, and finally one type byte per pad.
+ *
+ * A terrain is stored as what generates it rather than as its samples, and
+ * is regenerated on load once the pads are in, so it can be flattened
+ * under them (see `addTerrain()`).
+ *
+ * Like input logs, compiled levels are written as-is and only load on
+ * little-endian machines with IEEE floats.
+ */
+struct CompiledLevelHeader
+{
+    char     magic[4];
+    uint32_t version;
+    uint32_t landingPadCount;
+    uint32_t flags;
+    float    rocketX;
+    float    rocketY;
+    uint32_t terrainSeed;
+    float    terrainBaseY;
+    float    terrainAmplitude;
+};
+
+/**
+ * Read-only, memory-mapped view of a compiled level. The pad arrays point
+ * straight into the mapping, so loading a level is one bulk copy per array.
+ */
+class CompiledLevel
+{
+private:
+    const unsigned char *mData;
+    size_t               mSize;
+
+public:
+    CompiledLevel();
+    ~CompiledLevel();
+
+    CompiledLevel(const CompiledLevel &) = delete;
+    CompiledLevel &operator=(const CompiledLevel &) = delete;
+
+    bool open(const char *filepath);
+    void close();
+
+    const CompiledLevelHeader &getHeader() const { return *(const CompiledLevelHeader *) mData; }
+    int getLandingPadCount() const { return (int) getHeader().landingPadCount; }
+
+    const float *getPositionsX() const
+        { return (const float *) (mData + sizeof(CompiledLevelHeader)); }
+    const float *getPositionsY() const         { return getPositionsX() + getLandingPadCount();     }
+    const float *getColliderWidths() const     { return getPositionsX() + getLandingPadCount() * 2; }
+    const float *getColliderHeights() const    { return getPositionsX() + getLandingPadCount() * 3; }
+    const unsigned char *getEntityTypes() const
+        { return (const unsigned char *) (getPositionsX() + getLandingPadCount() * 4); }
+};
+
+void loadCompiledLevel(Simulation *simulation, const CompiledLevel &level);
+bool loadLevelFile(Simulation *simulation, const char *filepath);
+bool compileLevel(const char *sourcePath, const char *compiledPath);
+bool writeLevelSource(const Simulation &simulation, const char *filepath);
+
+#endif // LEVEL_FILE_H
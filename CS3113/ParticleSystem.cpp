@@ -0,0 +1,139 @@
+#include "ParticleSystem.h"
+
+// Enough padding past the capacity for a whole register of the widest
+// vector path
+constexpr int PARTICLE_PADDING = 8;
+
+ParticleSystem::ParticleSystem(int capacity, float gravity) :
+    mCapacity{capacity},
+    mCount{0},
+    mDroppedCount{0},
+    mGravity{gravity},
+    mColours(capacity)
+{
+    int paddedCapacity = (capacity + PARTICLE_PADDING - 1) / PARTICLE_PADDING * PARTICLE_PADDING;
+
+    AlignedFloats *fields[] = {
+        &mPositionX, &mPositionY, &mVelocityX, &mVelocityY,
+        &mLife, &mInverseLifetime, &mSize
+    };
+
+    // The padding lanes are stepped along with the live ones, so they need
+    // to hold numbers, not whatever the allocation had in it
+    for (AlignedFloats *field : fields)
+    {
+        field->allocate(paddedCapacity, ALIGNMENT);
+        for (int i = 0; i < paddedCapacity; i++) (*field)[i] = 0.0f;
+    }
+}
+
+/**
+ * Adds up to `count` particles from `emitter`. Whatever doesn't fit in the
+ * pool is dropped, and counted.
+ */
+void ParticleSystem::emit(const ParticleEmitter &emitter, int count)
+{
+    if (count > mCapacity - mCount)
+    {
+        mDroppedCount += count - (mCapacity - mCount);
+        count = mCapacity - mCount;
+    }
+
+    float heading = atan2f(emitter.direction.y, emitter.direction.x);
+
+    for (int n = 0; n < count; n++)
+    {
+        int   i        = mCount++;
+        float angle    = heading + mRandom.nextFloat(-emitter.spread, emitter.spread),
+              speed    = mRandom.nextFloat(emitter.minSpeed, emitter.maxSpeed),
+              lifetime = mRandom.nextFloat(emitter.minLifetime, emitter.maxLifetime);
+
+        mPositionX[i]       = emitter.position.x;
+        mPositionY[i]       = emitter.position.y;
+        mVelocityX[i]       = cosf(angle) * speed;
+        mVelocityY[i]       = sinf(angle) * speed;
+        mLife[i]            = lifetime;
+        mInverseLifetime[i] = 1.0f / lifetime;
+        mSize[i]            = emitter.size;
+        mColours[i]         = emitter.colour;
+    }
+}
+
+/**
+ * Fills the slot of every particle whose time is up with the last live
+ * one, keeping the live ones packed. Particles are all drawn in one batch
+ * with nothing depending on which is on top, so the order can change.
+ */
+void ParticleSystem::removeDead()
+{
+    for (int index = 0; index < mCount; )
+    {
+        if (mLife[index] > 0.0f)
+        {
+            index++;
+            continue;
+        }
+
+        int last = --mCount;
+
+        mPositionX[index]       = mPositionX[last];
+        mPositionY[index]       = mPositionY[last];
+        mVelocityX[index]       = mVelocityX[last];
+        mVelocityY[index]       = mVelocityY[last];
+        mLife[index]            = mLife[last];
+        mInverseLifetime[index] = mInverseLifetime[last];
+        mSize[index]            = mSize[last];
+        mColours[index]         = mColours[last];
+    }
+}
+
+/**
+ * Moves every particle on and ages it, one at a time, then clears out the
+ * dead ones. This is what `update()` does on builds without a vector
+ * instruction set.
+ */
+void ParticleSystem::updateScalar(float deltaTime)
+{
+    for (int i = 0; i < mCount; i++)
+    {
+        mVelocityY[i] += mGravity * deltaTime;
+        mPositionX[i] += mVelocityX[i] * deltaTime;
+        mPositionY[i] += mVelocityY[i] * deltaTime;
+        mLife[i]      -= deltaTime;
+    }
+
+    removeDead();
+}
+
+/**
+ * Moves every particle on by one frame under gravity, ages it, and clears
+ * out the ones whose time is up. The last register's worth can run past
+ * the live particles into the padding or dead slots, which is harmless:
+ * nothing reads them until they're emitted into again.
+ */
+void ParticleSystem::update(float deltaTime)
+{
+#if defined(__AVX__) || defined(__SSE2__)
+    typedef Lanes::Float Float;
+
+    const Float timestep = Lanes::set(deltaTime);
+    const Float gravity  = Lanes::set(mGravity * deltaTime);
+
+    for (int i = 0; i < mCount; i += Lanes::WIDTH)
+    {
+        Float velocityX = Lanes::load(mVelocityX.data() + i);
+        Float velocityY = Lanes::add(Lanes::load(mVelocityY.data() + i), gravity);
+
+        Lanes::store(mVelocityY.data() + i, velocityY);
+        Lanes::store(mPositionX.data() + i,
+            Lanes::add(Lanes::load(mPositionX.data() + i), Lanes::mul(velocityX, timestep)));
+        Lanes::store(mPositionY.data() + i,
+            Lanes::add(Lanes::load(mPositionY.data() + i), Lanes::mul(velocityY, timestep)));
+        Lanes::store(mLife.data() + i, Lanes::sub(Lanes::load(mLife.data() + i), timestep));
+    }
+
+    removeDead();
+#else
+    updateScalar(deltaTime);
+#endif
+}
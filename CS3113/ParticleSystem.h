@@ -0,0 +1,89 @@
+#ifndef PARTICLE_SYSTEM_H
+#define PARTICLE_SYSTEM_H
+
+#include "cs3113.h"
+#include "Lanes.h"
+#include "Random.h"
+
+/**
+ * How a burst of particles leaves its source: from `position`, heading
+ * within `spread` radians either side of `direction` (a unit vector), at a
+ * speed and for a lifetime picked evenly from their ranges. Every particle
+ * is a square `size` pixels across, fading out from `colour` as it ages.
+ */
+struct ParticleEmitter
+{
+    Vector2 position;
+    Vector2 direction;
+    float   spread;
+    float   minSpeed;
+    float   maxSpeed;
+    float   minLifetime;
+    float   maxLifetime;
+    float   size;
+    Color   colour;
+};
+
+/**
+ * A fixed-size pool of short-lived, purely visual particles: exhaust,
+ * debris. Nothing in here touches the simulation.
+ *
+ * Live particles are kept packed at the front of aligned arrays, one per
+ * field, so `update()` is one pass over them a full register at a time (AVX
+ * or SSE2, as in `LanderBatch`), with a scalar pass after it that moves the
+ * last live particle into each slot that died. All the storage is allocated
+ * up front; emitting into a full pool drops the new particles rather than
+ * growing it.
+ */
+class ParticleSystem
+{
+private:
+    static constexpr size_t ALIGNMENT = 32;
+
+    int   mCapacity;
+    int   mCount;
+    long  mDroppedCount;
+    float mGravity;
+
+    AlignedFloats mPositionX;
+    AlignedFloats mPositionY;
+    AlignedFloats mVelocityX;
+    AlignedFloats mVelocityY;
+
+    // Seconds left to live, and one over how long that was at the start, so
+    // drawing can fade them without a divide
+    AlignedFloats mLife;
+    AlignedFloats mInverseLifetime;
+
+    AlignedFloats      mSize;
+    std::vector<Color> mColours;
+
+    Random mRandom;
+
+    void removeDead();
+
+public:
+    ParticleSystem(int capacity, float gravity);
+
+    void emit(const ParticleEmitter &emitter, int count);
+    void update(float deltaTime);
+    void updateScalar(float deltaTime);
+    void clear() { mCount = 0; }
+
+    int  size()            const { return mCount;        }
+    int  getCapacity()     const { return mCapacity;     }
+    long getDroppedCount() const { return mDroppedCount; }
+
+    Vector2 getPosition(int index) const { return { mPositionX[index], mPositionY[index] }; }
+    float   getSize(int index)     const { return mSize[index]; }
+
+    // Its colour, faded by how much of its life it has left
+    Color getColour(int index) const
+    {
+        Color colour = mColours[index];
+        colour.a = (unsigned char) (colour.a * mLife[index] * mInverseLifetime[index]);
+        return colour;
+    }
+};
+
+#endif // PARTICLE_SYSTEM_H
@@ -0,0 +1,42 @@
+#ifndef PILOT_H
+#define PILOT_H
+
+#include "Simulation.h"
+#include "Random.h"
+
+/**
+ * A pilot that holds a random combination of thrusters for a random amount
+ * of time, then picks again. Enough to visit every game-over reason.
+ *
+ * Hold times are counted in 60 Hz ticks rather than steps, so the same seed
+ * flies the same way whatever timestep the simulation runs at.
+ */
+struct RandomPilot
+{
+    static constexpr float TICKS_PER_SECOND = 60.0f;
+
+    Random random;
+    int    ticksLeft = 0;
+    unsigned int thrusters = 0;
+
+    explicit RandomPilot(unsigned int seed = 1) : random { seed } {}
+
+    void fly(Simulation *simulation, float deltaTime)
+    {
+        if (ticksLeft <= 0)
+        {
+            thrusters = random.next() & 7;
+            ticksLeft = 6 + (int) (random.next() % 40);
+        }
+
+        int elapsed = (int) lroundf(deltaTime * TICKS_PER_SECOND);
+        ticksLeft -= elapsed > 0 ? elapsed : 1;
+
+        simulation->releaseThrusters();
+        if (thrusters & 1) simulation->accelerateUp();
+        if (thrusters & 2) simulation->accelerateLeft();
+        if (thrusters & 4) simulation->accelerateRight();
+    }
+};
+
+#endif // PILOT_H
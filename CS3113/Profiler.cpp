@@ -0,0 +1,196 @@
+#include "Profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+namespace
+{
+    struct Section
+    {
+        const char *name;
+        uint64_t    written;
+    };
+
+    struct ThreadBuffer
+    {
+        int                      threadId;
+        uint64_t                 written;
+        std::vector<Profiler::Event> events;
+
+        // One ring of durations per section, `SAMPLES_PER_SECTION` long, one
+        // after the other in `samples`
+        Section                  sections[Profiler::SECTIONS_PER_THREAD];
+        int                      sectionCount;
+        std::vector<int64_t>     samples;
+
+        // Scratch space for percentiles, sized up front so the overlay
+        // never allocates
+        std::vector<int64_t>     durations;
+    };
+
+    // Buffers outlive their threads so a trace can still include workers
+    // that have finished
+    std::mutex                                 gBuffersLock;
+    std::vector<std::unique_ptr<ThreadBuffer>> gBuffers;
+
+    thread_local ThreadBuffer *tBuffer = nullptr;
+
+    ThreadBuffer *getThreadBuffer()
+    {
+        if (tBuffer != nullptr) return tBuffer;
+
+        std::unique_ptr<ThreadBuffer> buffer(new ThreadBuffer());
+        buffer->written      = 0;
+        buffer->sectionCount = 0;
+        buffer->events.resize(Profiler::EVENTS_PER_THREAD);
+        buffer->samples.resize(Profiler::SECTIONS_PER_THREAD * Profiler::SAMPLES_PER_SECTION);
+        buffer->durations.reserve(Profiler::SAMPLES_PER_SECTION);
+
+        std::lock_guard<std::mutex> guard(gBuffersLock);
+        buffer->threadId = (int) gBuffers.size();
+        tBuffer = buffer.get();
+        gBuffers.push_back(std::move(buffer));
+
+        return tBuffer;
+    }
+
+    /**
+     * The section `name` is kept under, by pointer first since names are
+     * literals, then by text in case one name was spelled out twice.
+     *
+     * @return its index, or -1 if it has none.
+     */
+    int findSection(const ThreadBuffer &buffer, const char *name)
+    {
+        for (int i = 0; i < buffer.sectionCount; i++)
+            if (buffer.sections[i].name == name) return i;
+
+        for (int i = 0; i < buffer.sectionCount; i++)
+            if (strcmp(buffer.sections[i].name, name) == 0) return i;
+
+        return -1;
+    }
+}
+
+// Nanoseconds on a monotonic clock
+int64_t Profiler::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Profiler::record(const char *name, int64_t start, int64_t end)
+{
+    ThreadBuffer *buffer = getThreadBuffer();
+
+    Event &event   = buffer->events[buffer->written % EVENTS_PER_THREAD];
+    event.name     = name;
+    event.start    = start;
+    event.duration = end - start;
+
+    buffer->written++;
+
+    int section = findSection(*buffer, name);
+    if (section < 0)
+    {
+        // Past the limit a section is still traced, just not summarised
+        if (buffer->sectionCount == SECTIONS_PER_THREAD) return;
+
+        section = buffer->sectionCount++;
+        buffer->sections[section] = { name, 0 };
+    }
+
+    Section &ring = buffer->sections[section];
+    buffer->samples[section * SAMPLES_PER_SECTION + ring.written % SAMPLES_PER_SECTION] = end - start;
+    ring.written++;
+}
+
+/**
+ * Summarises the latest `SAMPLES_PER_SECTION` runs of one section on the
+ * calling thread.
+ *
+ * @return the count, and the median and 99th percentile durations in
+ * milliseconds; all zero if the section hasn't run.
+ */
+Profiler::SectionStats Profiler::getSectionStats(const char *name)
+{
+    SectionStats stats = { 0, 0.0f, 0.0f };
+    if (tBuffer == nullptr) return stats;
+
+    ThreadBuffer *buffer = tBuffer;
+    int section = findSection(*buffer, name);
+    if (section < 0) return stats;
+
+    uint64_t count = std::min<uint64_t>(buffer->sections[section].written, SAMPLES_PER_SECTION);
+    const int64_t *samples = &buffer->samples[section * SAMPLES_PER_SECTION];
+
+    std::vector<int64_t> &durations = buffer->durations;
+    durations.assign(samples, samples + count);
+
+    size_t median = durations.size() / 2,
+           tail   = durations.size() * 99 / 100;
+
+    std::nth_element(durations.begin(), durations.begin() + median, durations.end());
+    stats.p50 = durations[median] / 1e6f;
+
+    std::nth_element(durations.begin(), durations.begin() + tail, durations.end());
+    stats.p99 = durations[tail] / 1e6f;
+
+    stats.count = (int) durations.size();
+    return stats;
+}
+
+/**
+ * Writes every thread's buffered events as a Chrome trace (the JSON that
+ * chrome://tracing and Perfetto open). Threads must not be recording while
+ * this runs.
+ *
+ * @return `false` if the file couldn't be written.
+ */
+bool Profiler::writeChromeTrace(const char *filepath)
+{
+    FILE *file = fopen(filepath, "w");
+    if (file == nullptr) return false;
+
+    std::lock_guard<std::mutex> guard(gBuffersLock);
+
+    // Timestamps are relative to the oldest event so they stay readable
+    int64_t origin = INT64_MAX;
+    for (size_t i = 0; i < gBuffers.size(); i++)
+    {
+        const ThreadBuffer &buffer = *gBuffers[i];
+        uint64_t count = std::min<uint64_t>(buffer.written, EVENTS_PER_THREAD);
+        for (uint64_t k = 0; k < count; k++) origin = std::min(origin, buffer.events[k].start);
+    }
+
+    fprintf(file, "{\"traceEvents\":[");
+
+    bool first = true;
+    for (size_t i = 0; i < gBuffers.size(); i++)
+    {
+        const ThreadBuffer &buffer = *gBuffers[i];
+        uint64_t count = std::min<uint64_t>(buffer.written, EVENTS_PER_THREAD);
+
+        // Oldest first; once the ring has wrapped that's the slot about to
+        // be overwritten
+        uint64_t oldest = buffer.written - count;
+        for (uint64_t k = oldest; k < buffer.written; k++)
+        {
+            const Event &event = buffer.events[k % EVENTS_PER_THREAD];
+
+            fprintf(file, "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                first ? "" : ",", event.name, buffer.threadId,
+                (event.start - origin) / 1000.0, event.duration / 1000.0);
+            first = false;
+        }
+    }
+
+    fprintf(file, "\n],\"displayTimeUnit\":\"ms\"}\n");
+
+    return fclose(file) == 0;
+}
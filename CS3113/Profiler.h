@@ -0,0 +1,74 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <stdint.h>
+
+/**
+ * Scoped section timers for finding where a frame's time goes.
+ *
+ * `PROFILE_SCOPE("name")` times the rest of the enclosing block and appends
+ * it to a ring buffer owned by the calling thread, so recording never takes
+ * a lock and only the most recent `EVENTS_PER_THREAD` sections are kept.
+ * Names must be string literals (or otherwise outlive the profiler); only
+ * the pointer is stored.
+ *
+ * Each thread also keeps its first `SECTIONS_PER_THREAD` section names'
+ * latest `SAMPLES_PER_SECTION` durations apart, as they're recorded, so
+ * percentiles for a section only ever look at that section's runs.
+ *
+ * Timers are only compiled in when `ENABLE_PROFILER` is defined. Without it
+ * `PROFILE_SCOPE` expands to nothing at all, and the rest of the API still
+ * links but has nothing to report.
+ */
+class Profiler
+{
+public:
+    struct Event
+    {
+        const char *name;
+        int64_t     start;
+        int64_t     duration;
+    };
+
+    struct SectionStats
+    {
+        int   count;
+        float p50;
+        float p99;
+    };
+
+    static constexpr int EVENTS_PER_THREAD   = 1 << 16;
+    static constexpr int SECTIONS_PER_THREAD = 16;
+    static constexpr int SAMPLES_PER_SECTION = 1024;
+
+    static int64_t now();
+    static void    record(const char *name, int64_t start, int64_t end);
+
+    static SectionStats getSectionStats(const char *name);
+    static bool         writeChromeTrace(const char *filepath);
+};
+
+class ProfileScope
+{
+private:
+    const char *mName;
+    int64_t     mStart;
+
+public:
+    explicit ProfileScope(const char *name) : mName{name}, mStart{Profiler::now()} {}
+    ~ProfileScope() { Profiler::record(mName, mStart, Profiler::now()); }
+
+    ProfileScope(const ProfileScope &) = delete;
+    ProfileScope &operator=(const ProfileScope &) = delete;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b)       PROFILE_CONCAT_INNER(a, b)
+
+#ifdef ENABLE_PROFILER
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
+#else
+#define PROFILE_SCOPE(name)
+#endif
+
+#endif // PROFILER_H
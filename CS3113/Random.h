@@ -0,0 +1,43 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+/**
+ * Small xorshift generator; deterministic across platforms, which `rand()`
+ * isn't, and cheap enough to keep one per worker.
+ */
+struct Random
+{
+    unsigned int state;
+
+    explicit Random(unsigned int seed = 1) : state { seed ? seed : 1u } {}
+
+    unsigned int next()
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    // Uniform in [0, 1)
+    float nextFloat() { return (next() >> 8) * (1.0f / 16777216.0f); }
+
+    float nextFloat(float min, float max) { return min + nextFloat() * (max - min); }
+};
+
+/**
+ * Derives an independent seed for one stream (an episode, a worker...) from a
+ * base seed, so results don't depend on which thread ran which stream.
+ */
+inline unsigned int mixSeed(unsigned int seed, unsigned int stream)
+{
+    unsigned int hash = seed * 0x9E3779B9u ^ (stream + 0x7F4A7C15u);
+    hash ^= hash >> 16;
+    hash *= 0x85EBCA6Bu;
+    hash ^= hash >> 13;
+    hash *= 0xC2B2AE35u;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+#endif // RANDOM_H
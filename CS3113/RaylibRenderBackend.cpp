@@ -0,0 +1,125 @@
+#include "RaylibRenderBackend.h"
+#include "ParticleSystem.h"
+
+#include <algorithm>
+
+namespace
+{
+    // Untextured shapes still go through a texture: rlgl's default one, a
+    // single white texel, so they come out in exactly their own colour.
+    // Binding it explicitly keeps them out of whatever draw came before,
+    // since rlgl only falls back to it on its own when the draw mode changes
+    void bindWhiteTexture() { rlSetTexture(rlGetTextureIdDefault()); }
+
+    void whiteVertex(float x, float y)
+    {
+        rlTexCoord2f(0.0f, 0.0f);
+        rlVertex2f(x, y);
+    }
+
+    /**
+     * Draws a whole mesh as one run of triangles, making room in rlgl's
+     * batch for all of it first so it isn't split partway through.
+     */
+    void drawMesh(const Mesh2D &mesh, Color colour)
+    {
+        int vertexCount = (int) mesh.vertices.size();
+
+        rlCheckRenderBatchLimit(vertexCount);
+
+        bindWhiteTexture();
+        rlBegin(RL_TRIANGLES);
+
+            rlColor4ub(colour.r, colour.g, colour.b, colour.a);
+
+            for (int i = 0; i < vertexCount; i++)
+                whiteVertex(mesh.vertices[i].x, mesh.vertices[i].y);
+
+        rlEnd();
+        rlSetTexture(0);
+    }
+
+    /**
+     * Draws every live particle as a plain square, a few thousand to
+     * a draw: each run is sized to fit in rlgl's batch, which holds 8192
+     * quads by default, so none is split partway through.
+     */
+    void drawParticles(const ParticleSystem &particles)
+    {
+        constexpr int PARTICLES_PER_DRAW = 4096;
+
+        for (int first = 0; first < particles.size(); first += PARTICLES_PER_DRAW)
+        {
+            int last = std::min(first + PARTICLES_PER_DRAW, particles.size());
+
+            rlCheckRenderBatchLimit((last - first) * 4);
+
+            bindWhiteTexture();
+            rlBegin(RL_QUADS);
+
+                for (int i = first; i < last; i++)
+                {
+                    Vector2 position = particles.getPosition(i);
+                    float   half     = particles.getSize(i) / 2.0f;
+                    Color   colour   = particles.getColour(i);
+
+                    rlColor4ub(colour.r, colour.g, colour.b, colour.a);
+                    whiteVertex(position.x - half, position.y - half);
+                    whiteVertex(position.x - half, position.y + half);
+                    whiteVertex(position.x + half, position.y + half);
+                    whiteVertex(position.x + half, position.y - half);
+                }
+
+            rlEnd();
+            rlSetTexture(0);
+        }
+    }
+}
+
+void RaylibRenderBackend::submit(const RenderCommandList &list)
+{
+    for (int i = 0; i < list.size(); i++)
+    {
+        const RenderCommand &command = list.getCommand(i);
+
+        // The batch has to be drawn before anything that goes over it: a new
+        // layer, or anything that isn't a sprite
+        if (i > 0 && (command.type != DRAW_SPRITE || command.layer != list.getCommand(i - 1).layer))
+            mSpriteBatch.flush();
+
+        const Rectangle &rectangle = command.destination;
+
+        switch (command.type)
+        {
+            case DRAW_SPRITE:
+                mSpriteBatch.draw(command.texture, command.source, rectangle,
+                    command.origin, command.rotation, command.colour);
+                break;
+
+            case DRAW_RECTANGLE:
+                DrawRectangle((int) rectangle.x, (int) rectangle.y,
+                    (int) rectangle.width, (int) rectangle.height, command.colour);
+                break;
+
+            case DRAW_RECTANGLE_LINES:
+                DrawRectangleLines((int) rectangle.x, (int) rectangle.y,
+                    (int) rectangle.width, (int) rectangle.height, command.colour);
+                break;
+
+            case DRAW_TEXT:
+                DrawText(list.getText(command), (int) rectangle.x, (int) rectangle.y,
+                    command.fontSize, command.colour);
+                break;
+
+            case DRAW_MESH:
+                drawMesh(*command.mesh, command.colour);
+                break;
+
+            case DRAW_PARTICLES:
+                drawParticles(*command.particles);
+                break;
+        }
+    }
+
+    mSpriteBatch.flush();
+}
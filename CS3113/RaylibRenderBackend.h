@@ -0,0 +1,25 @@
+#ifndef RAYLIB_RENDER_BACKEND_H
+#define RAYLIB_RENDER_BACKEND_H
+
+#include "RenderCommands.h"
+#include "SpriteBatch.h"
+
+/**
+ * Draws a command list with raylib. Runs of sprites go through a
+ * `SpriteBatch`, so a sorted list draws each texture's sprites on a layer in
+ * one call; meshes and particles go straight to rlgl as long runs of
+ * triangles and quads, and everything else is drawn as it comes, with
+ * raylib's own functions. Call between `BeginDrawing()` and `EndDrawing()`.
+ */
+class RaylibRenderBackend
+{
+private:
+    SpriteBatch mSpriteBatch;
+
+public:
+    explicit RaylibRenderBackend(Rectangle view) : mSpriteBatch {view} {}
+
+    void submit(const RenderCommandList &list);
+};
+
+#endif // RAYLIB_RENDER_BACKEND_H
@@ -0,0 +1,157 @@
+#include "RenderCommands.h"
+
+#include <algorithm>
+#include <string.h>
+
+// The state takes up the 24 bits between the layer and the index
+constexpr int      RENDER_STATE_SHIFT = 32,
+                   RENDER_LAYER_SHIFT = 56;
+constexpr uint64_t RENDER_STATE_MASK  = 0xffffff;
+
+void RenderCommandList::clear()
+{
+    mCommands.clear();
+    mText.clear();
+    mOrder.clear();
+}
+
+RenderCommand &RenderCommandList::add(RenderCommandType type, RenderLayer layer, Texture2D texture)
+{
+    uint64_t index = mCommands.size();
+
+    mCommands.push_back(RenderCommand());
+    RenderCommand &command = mCommands.back();
+    command.type    = type;
+    command.layer   = layer;
+    command.texture = texture;
+
+    mOrder.push_back(((uint64_t) layer << RENDER_LAYER_SHIFT) |
+        ((getRenderState(command) & RENDER_STATE_MASK) << RENDER_STATE_SHIFT) | index);
+
+    return command;
+}
+
+void RenderCommandList::drawSprite(RenderLayer layer, Texture2D texture, Rectangle source,
+    Rectangle destination, Vector2 origin, float rotation, Color tint)
+{
+    RenderCommand &command = add(DRAW_SPRITE, layer, texture);
+    command.source      = source;
+    command.destination = destination;
+    command.origin      = origin;
+    command.rotation    = rotation;
+    command.colour      = tint;
+}
+
+void RenderCommandList::drawRectangle(RenderLayer layer, Rectangle rectangle, Color colour)
+{
+    RenderCommand &command = add(DRAW_RECTANGLE, layer, {});
+    command.destination = rectangle;
+    command.colour      = colour;
+}
+
+void RenderCommandList::drawRectangleLines(RenderLayer layer, Rectangle rectangle, Color colour)
+{
+    RenderCommand &command = add(DRAW_RECTANGLE_LINES, layer, {});
+    command.destination = rectangle;
+    command.colour      = colour;
+}
+
+void RenderCommandList::drawText(RenderLayer layer, const char *text, int x, int y,
+    int fontSize, Color colour)
+{
+    RenderCommand &command = add(DRAW_TEXT, layer, {});
+    command.destination = { (float) x, (float) y, 0.0f, 0.0f };
+    command.fontSize    = fontSize;
+    command.colour      = colour;
+    command.textOffset  = (int) mText.size();
+
+    mText.insert(mText.end(), text, text + strlen(text) + 1);
+}
+
+void RenderCommandList::drawMesh(RenderLayer layer, const Mesh2D *mesh, Color colour)
+{
+    RenderCommand &command = add(DRAW_MESH, layer, {});
+    command.mesh   = mesh;
+    command.colour = colour;
+}
+
+void RenderCommandList::drawParticles(RenderLayer layer, const ParticleSystem *particles)
+{
+    RenderCommand &command = add(DRAW_PARTICLES, layer, {});
+    command.particles = particles;
+}
+
+/**
+ * Puts the commands in submission order. Most frames arrive nearly sorted
+ * already (every pad, then the rocket, then the HUD), so it checks first.
+ */
+void RenderCommandList::sort()
+{
+    if (!std::is_sorted(mOrder.begin(), mOrder.end())) std::sort(mOrder.begin(), mOrder.end());
+}
+
+/**
+ * How many times the GPU state changes submitting `list` in its current
+ * order, counting setting it for the first command.
+ */
+int countStateChanges(const RenderCommandList &list)
+{
+    int changes = 0;
+
+    for (int i = 0; i < list.size(); i++)
+        if (i == 0 || getRenderState(list.getCommand(i)) != getRenderState(list.getCommand(i - 1)))
+            changes++;
+
+    return changes;
+}
+
+/**
+ * Compares two lists command by command, in submission order.
+ *
+ * @return the index of the first command that differs (or that only one of
+ * them has), or -1 if they would draw exactly the same thing.
+ */
+int findFirstDifference(const RenderCommandList &a, const RenderCommandList &b)
+{
+    int count = std::min(a.size(), b.size());
+
+    for (int i = 0; i < count; i++)
+    {
+        const RenderCommand &x = a.getCommand(i);
+        const RenderCommand &y = b.getCommand(i);
+
+        bool isSame =
+            x.type == y.type && x.layer == y.layer && x.texture.id == y.texture.id &&
+            x.source.x == y.source.x && x.source.y == y.source.y &&
+            x.source.width == y.source.width && x.source.height == y.source.height &&
+            x.destination.x == y.destination.x && x.destination.y == y.destination.y &&
+            x.destination.width == y.destination.width && x.destination.height == y.destination.height &&
+            x.origin.x == y.origin.x && x.origin.y == y.origin.y && x.rotation == y.rotation &&
+            x.colour.r == y.colour.r && x.colour.g == y.colour.g &&
+            x.colour.b == y.colour.b && x.colour.a == y.colour.a &&
+            x.fontSize == y.fontSize && x.mesh == y.mesh &&
+            x.particles == y.particles &&
+            (x.type != DRAW_TEXT || strcmp(a.getText(x), b.getText(y)) == 0);
+
+        if (!isSame) return i;
+    }
+
+    return a.size() == b.size() ? -1 : count;
+}
+
+NullRenderBackend::NullRenderBackend()
+{
+    reset();
+}
+
+void NullRenderBackend::submit(const RenderCommandList &list)
+{
+    for (int i = 0; i < list.size(); i++) mCommandCounts[list.getCommand(i).type]++;
+    mStateChanges += countStateChanges(list);
+}
+
+void NullRenderBackend::reset()
+{
+    for (int i = 0; i < RENDER_COMMAND_TYPE_COUNT; i++) mCommandCounts[i] = 0;
+    mStateChanges = 0;
+}
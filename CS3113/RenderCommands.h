@@ -0,0 +1,133 @@
+#ifndef RENDER_COMMANDS_H
+#define RENDER_COMMANDS_H
+
+#include "cs3113.h"
+
+#include <stdint.h>
+
+enum RenderCommandType  { DRAW_SPRITE, DRAW_RECTANGLE, DRAW_RECTANGLE_LINES, DRAW_TEXT, DRAW_MESH,
+                          DRAW_PARTICLES };
+constexpr int           RENDER_COMMAND_TYPE_COUNT = 6;
+
+// Back to front. Sorting keeps layers in this order; within a layer it's
+// free to reorder, so anything that has to be drawn over something else
+// goes on a later layer
+enum RenderLayer        { LAYER_TERRAIN, LAYER_LEVEL, LAYER_PARTICLES, LAYER_ENTITIES, LAYER_DEBUG,
+                          LAYER_HUD, LAYER_OVERLAY };
+
+class ParticleSystem;
+
+/**
+ * Untextured triangles, three vertices each, counter-clockwise on screen.
+ * Built once and drawn every frame by pointer, so a mesh of any size costs
+ * a frame's command list one command.
+ */
+struct Mesh2D
+{
+    std::vector<Vector2> vertices;
+};
+
+/**
+ * One thing to draw. Which fields mean anything depends on `type`:
+ * sprites use everything but `fontSize`, `textOffset` and the pointers,
+ * and take the same arguments as raylib's `DrawTexturePro()`; rectangles
+ * use `destination` and `colour`; text uses `destination`'s x and y,
+ * `fontSize`, `colour` and its string in the list's text storage; meshes
+ * use `mesh` and `colour`; particles use `particles` alone, since each
+ * particle has its own colour.
+ */
+struct RenderCommand
+{
+    RenderCommandType     type;
+    RenderLayer           layer;
+    Texture2D             texture;
+    Rectangle             source;
+    Rectangle             destination;
+    Vector2               origin;
+    float                 rotation;
+    Color                 colour;
+    int                   fontSize;
+    int                   textOffset;
+    const Mesh2D         *mesh;
+    const ParticleSystem *particles;
+};
+
+/**
+ * A frame's draw calls, recorded rather than made, so they can be sorted
+ * before a backend submits them, and counted or compared without a GPU.
+ *
+ * `sort()` orders commands by layer, then by the GPU state they need (their
+ * texture, and the kind of primitive), then by when they were added, so
+ * every sprite with the same texture on a layer goes out in one run. Until
+ * it's called, commands are in the order they were added.
+ *
+ * Text is copied in, so it can come from a buffer that's gone by the time
+ * the list is submitted. Meshes and particles aren't: they have to outlive
+ * the list. Storage is kept across `clear()`, so a list that
+ * has seen a frame's worth of commands doesn't allocate again.
+ */
+class RenderCommandList
+{
+private:
+    std::vector<RenderCommand> mCommands;
+    std::vector<char>          mText;
+
+    // Sort keys: layer, then state, then the command's index in the low 32
+    // bits, so sorting the keys sorts the commands stably
+    std::vector<uint64_t>      mOrder;
+
+    RenderCommand &add(RenderCommandType type, RenderLayer layer, Texture2D texture);
+
+public:
+    void clear();
+
+    void drawSprite(RenderLayer layer, Texture2D texture, Rectangle source,
+        Rectangle destination, Vector2 origin, float rotation, Color tint);
+    void drawRectangle(RenderLayer layer, Rectangle rectangle, Color colour);
+    void drawRectangleLines(RenderLayer layer, Rectangle rectangle, Color colour);
+    void drawText(RenderLayer layer, const char *text, int x, int y, int fontSize, Color colour);
+    void drawMesh(RenderLayer layer, const Mesh2D *mesh, Color colour);
+    void drawParticles(RenderLayer layer, const ParticleSystem *particles);
+
+    void sort();
+
+    int size() const { return (int) mOrder.size(); }
+
+    // The `index`th command to submit
+    const RenderCommand &getCommand(int index) const
+        { return mCommands[mOrder[index] & 0xffffffffu]; }
+    const char *getText(const RenderCommand &command) const
+        { return &mText[command.textOffset]; }
+};
+
+// Two commands can share a draw call when these match
+inline uint32_t getRenderState(const RenderCommand &command)
+{
+    return command.texture.id * RENDER_COMMAND_TYPE_COUNT + command.type;
+}
+
+int countStateChanges(const RenderCommandList &list);
+int findFirstDifference(const RenderCommandList &a, const RenderCommandList &b);
+
+/**
+ * A backend that draws nothing and keeps count instead: how many commands
+ * of each kind it was given, and how many times the GPU state would have
+ * changed submitting them. Needs no window.
+ */
+class NullRenderBackend
+{
+private:
+    int mCommandCounts[RENDER_COMMAND_TYPE_COUNT];
+    int mStateChanges;
+
+public:
+    NullRenderBackend();
+
+    void submit(const RenderCommandList &list);
+    void reset();
+
+    int getCommandCount(RenderCommandType type) const { return mCommandCounts[type]; }
+    int getStateChanges()                        const { return mStateChanges;        }
+};
+
+#endif // RENDER_COMMANDS_H
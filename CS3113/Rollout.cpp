@@ -0,0 +1,136 @@
+#include "Rollout.h"
+#include "Level.h"
+#include "Pilot.h"
+#include "WorkStealing.h"
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    constexpr long EPISODES_PER_CHUNK = 16;
+
+    // One per worker, each on its own cache lines so workers never write to
+    // a line another worker is writing to
+    struct WorkerState
+    {
+        char         padding[64];
+        Simulation   simulation;
+        RolloutStats stats;
+    };
+
+    /**
+     * Plays one randomized episode to the end (or to `maxSteps`). Everything
+     * random about it comes from the episode's own seed, so an episode plays
+     * out identically whichever worker runs it.
+     */
+    void runEpisode(const RolloutConfig &config, long episode, WorkerState *worker)
+    {
+        Simulation &simulation = worker->simulation;
+
+        RandomPilot pilot(startEpisode(config, episode, &simulation));
+
+        RolloutStats &stats = worker->stats;
+
+        int  steps = 0;
+        bool ended = false;
+        while (!ended && steps < config.maxSteps)
+        {
+            pilot.fly(&simulation, config.timestep);
+            simulation.step(config.timestep);
+            steps++;
+
+            const std::vector<SimulationEvent> &events = simulation.getEvents();
+            for (size_t i = 0; i < events.size(); i++)
+            {
+                if (events[i].type == PAD_CONTACT) stats.padContacts++;
+                else
+                {
+                    stats.outcomes[events[i].reason]++;
+                    ended = true;
+                }
+            }
+        }
+
+        stats.episodes++;
+        stats.steps += steps;
+
+        if (!ended) stats.timeouts++;
+    }
+}
+
+/**
+ * Loads episode number `episode` of a rollout into `simulation`: the level,
+ * plus the rocket's randomized starting position and velocity.
+ *
+ * @return the seed the episode's pilot should fly with.
+ */
+unsigned int startEpisode(const RolloutConfig &config, long episode, Simulation *simulation)
+{
+    unsigned int episodeSeed = mixSeed(config.seed, (unsigned int) episode);
+    Random random(episodeSeed);
+
+    Vector2 rocketPosition = {
+        random.nextFloat(100.0f, 1400.0f),
+        random.nextFloat(50.0f,  350.0f)
+    };
+    Vector2 rocketVelocity = {
+        random.nextFloat(-20.0f, 20.0f),
+        random.nextFloat(-10.0f, 10.0f)
+    };
+
+    if (config.landingPads > 0) loadRandomLevel(simulation, rocketPosition, config.landingPads, episodeSeed);
+    else                        loadDefaultLevel(simulation, rocketPosition);
+
+    simulation->setRocketVelocity(rocketVelocity);
+
+    return random.next();
+}
+
+/**
+ * Plays `config.episodes` randomized landings spread across threads and
+ * tallies how each one ended. Each episode is an independent world, so the
+ * only thing workers share is the scheduler.
+ *
+ * Results depend only on the config, never on the thread count or on how
+ * the episodes happened to be scheduled.
+ */
+RolloutStats runRollouts(const RolloutConfig &config)
+{
+    int threadCount = config.threads > 0 ?
+        config.threads : (int) std::thread::hardware_concurrency();
+    if (threadCount < 1) threadCount = 1;
+
+    std::unique_ptr<WorkerState[]> workers(new WorkerState[threadCount]);
+    for (int i = 0; i < threadCount; i++) workers[i].stats = {};
+
+    auto start = std::chrono::steady_clock::now();
+
+    WorkStealingScheduler scheduler;
+    scheduler.run(config.episodes, EPISODES_PER_CHUNK, threadCount,
+        [&](int worker, long begin, long end)
+        {
+            for (long episode = begin; episode < end; episode++)
+                runEpisode(config, episode, &workers[worker]);
+        });
+
+    RolloutStats total = {};
+    total.threads = threadCount;
+    total.seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+
+    for (int i = 0; i < threadCount; i++)
+    {
+        const RolloutStats &stats = workers[i].stats;
+
+        total.episodes += stats.episodes;
+        total.timeouts += stats.timeouts;
+        total.steps    += stats.steps;
+        total.padContacts += stats.padContacts;
+        for (int reason = 0; reason < GAME_OVER_REASON_COUNT; reason++)
+            total.outcomes[reason] += stats.outcomes[reason];
+    }
+
+    return total;
+}
@@ -0,0 +1,44 @@
+#ifndef ROLLOUT_H
+#define ROLLOUT_H
+
+#include "Simulation.h"
+
+struct RolloutConfig
+{
+    long         episodes    = 10000;
+    unsigned int seed        = 1;
+
+    // 0 plays the stock level; anything else generates a fresh random level
+    // with that many pads for every episode
+    int          landingPads = 0;
+
+    // 0 uses one thread per hardware thread
+    int          threads     = 0;
+
+    int          maxSteps    = 60 * 60 * 5;
+    float        timestep    = 1.0f / 60.0f;
+};
+
+struct RolloutStats
+{
+    long   episodes;
+    long   outcomes[GAME_OVER_REASON_COUNT];
+    long   timeouts;
+    long   steps;
+
+    // Pads touched, counted once per pad per step
+    long   padContacts;
+
+    int    threads;
+    double seconds;
+
+    double getRate(GameOverReason reason) const
+        { return episodes > 0 ? (double) outcomes[reason] / episodes : 0.0; }
+    double getTimeoutRate() const
+        { return episodes > 0 ? (double) timeouts / episodes : 0.0; }
+};
+
+unsigned int startEpisode(const RolloutConfig &config, long episode, Simulation *simulation);
+RolloutStats runRollouts(const RolloutConfig &config);
+
+#endif // ROLLOUT_H
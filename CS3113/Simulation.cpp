@@ -0,0 +1,497 @@
+#include "Simulation.h"
+#include "LanderBatch.h"
+#include "Profiler.h"
+
+#include <algorithm>
+
+Simulation::Simulation()
+{
+    // A step rarely touches more than a couple of pads; reserving keeps
+    // emitting events off the heap
+    mEvents.reserve(16);
+
+    reset();
+}
+
+/**
+ * Clears the world back to an empty state: no landing pads or terrain, a stationary
+ * rocket at the origin with a full tank, and no game over.
+ */
+void Simulation::reset()
+{
+    mWorld.clear();
+    mBroadphase.markDirty();
+    mTerrain.clear();
+    mWorld.create(ROCKET, { 0.0f, 0.0f }, { 0.0f, 0.0f });
+
+    mRocket = {};
+    mRocket.accelerationY = GRAVITATIONAL_ACCELERATION;
+    mRocket.fuelTank      = STARTING_FUEL;
+
+    mIsGameOver     = false;
+    mGameOverReason = OUT_OF_BOUNDS;
+
+    mEvents.clear();
+}
+
+void Simulation::setRocket(Vector2 position, Vector2 colliderDimensions)
+{
+    mWorld.positionX[ROCKET_HANDLE]      = position.x;
+    mWorld.positionY[ROCKET_HANDLE]      = position.y;
+    mWorld.colliderWidth[ROCKET_HANDLE]  = colliderDimensions.x;
+    mWorld.colliderHeight[ROCKET_HANDLE] = colliderDimensions.y;
+    mRocket.previousPositionX            = position.x;
+    mRocket.previousPositionY            = position.y;
+}
+
+void Simulation::setRocketVelocity(Vector2 velocity)
+{
+    mRocket.velocityX = velocity.x;
+    mRocket.velocityY = velocity.y;
+}
+
+/**
+ * Adds a landing pad to the world. Moving pads start off heading right and
+ * patrol around the position they were created at.
+ *
+ * @return the handle of the new pad.
+ */
+EntityHandle Simulation::addLandingPad(Vector2 position, Vector2 colliderDimensions,
+    EntityType entityType)
+{
+    EntityHandle landingPad = mWorld.create(entityType, position, colliderDimensions);
+    mBroadphase.markDirty();
+
+    if (entityType == MOVING_LANDING_PAD) mWorld.movingPads.velocityX.back() = LANDING_PAD_SPEED;
+
+    return landingPad;
+}
+
+/**
+ * Adds a whole level's worth of landing pads at once, from parallel arrays;
+ * see `EntityWorld::createMany()`. Types must be `FIXED_LANDING_PAD` or
+ * `MOVING_LANDING_PAD`.
+ *
+ * @return the handle of the first new pad.
+ */
+EntityHandle Simulation::addLandingPads(int count, const float *positionsX,
+    const float *positionsY, const float *colliderWidths,
+    const float *colliderHeights, const unsigned char *entityTypes)
+{
+    int firstMovingPad = mWorld.movingPads.size();
+
+    EntityHandle first = mWorld.createMany(count, positionsX, positionsY,
+        colliderWidths, colliderHeights, entityTypes);
+    mBroadphase.markDirty();
+
+    std::fill(mWorld.movingPads.velocityX.begin() + firstMovingPad,
+        mWorld.movingPads.velocityX.end(), LANDING_PAD_SPEED);
+
+    return first;
+}
+
+/**
+ * Thrusters are held: once switched on they fire on every step until
+ * `releaseThrusters()` is called, so one frame of input covers however many
+ * substeps that frame runs.
+ */
+void Simulation::accelerateUp()
+{
+    if (mRocket.fuelTank > 0.0f && !mIsGameOver) mRocket.acceleratingUp = true;
+}
+
+void Simulation::accelerateLeft()
+{
+    if (mRocket.fuelTank > 0.0f && !mIsGameOver) mRocket.acceleratingLeft = true;
+}
+
+void Simulation::accelerateRight()
+{
+    if (mRocket.fuelTank > 0.0f && !mIsGameOver) mRocket.acceleratingRight = true;
+}
+
+void Simulation::releaseThrusters()
+{
+    mRocket.acceleratingRight = mRocket.acceleratingLeft = mRocket.acceleratingUp = false;
+}
+
+/**
+ * Checks if the rocket is colliding with another entity based on their
+ * positions and collider dimensions.
+ *
+ * @param other the handle of the entity to test the rocket against.
+ *
+ * @return returns `true` if the two bodies are colliding based on their
+ * positions and collider dimensions, and `false` otherwise.
+ */
+bool Simulation::isColliding(EntityHandle other) const
+{
+    const EntityWorld &w = mWorld;
+
+    float xDistance = fabs(w.positionX[ROCKET_HANDLE] - w.positionX[other]) -
+        ((w.colliderWidth[ROCKET_HANDLE] + w.colliderWidth[other]) / 2.0f);
+    float yDistance = fabs(w.positionY[ROCKET_HANDLE] - w.positionY[other]) -
+        ((w.colliderHeight[ROCKET_HANDLE] + w.colliderHeight[other]) / 2.0f);
+
+    if (xDistance < 0.0f && yDistance < 0.0f) return true;
+
+    return false;
+}
+
+/**
+ * Checks the rocket against another entity and resolves any vertical overlap
+ * by adjusting the rocket's position and velocity accordingly.
+ *
+ * @param other the handle of the entity the rocket can potentially collide
+ * with.
+ */
+void Simulation::checkCollisionY(EntityHandle other)
+{
+    if (!isColliding(other)) return;
+
+    EntityWorld &w = mWorld;
+
+    // Calculate the distance between its centre and our centre and use that
+    // to calculate the amount of overlap between both bodies.
+    float yDistance = fabs(w.positionY[ROCKET_HANDLE] - w.positionY[other]);
+    float yOverlap  = fabs(yDistance - (w.colliderHeight[ROCKET_HANDLE] / 2.0f) - (w.colliderHeight[other] / 2.0f));
+
+    // "Unclip" ourselves from the other entity, and zero our vertical
+    // velocity.
+    if (mRocket.velocityY > 0)
+    {
+        w.positionY[ROCKET_HANDLE] -= yOverlap;
+        mRocket.velocityY  = 0;
+        mRocket.isCollidingBottom = true;
+    } else if (mRocket.velocityY < 0)
+    {
+        w.positionY[ROCKET_HANDLE] += yOverlap;
+        mRocket.velocityY  = 0;
+        mRocket.isCollidingTop = true;
+    }
+}
+
+void Simulation::checkCollisionX(EntityHandle other)
+{
+    if (!isColliding(other)) return;
+
+    EntityWorld &w = mWorld;
+
+    // When standing on a platform, we're always slightly overlapping it
+    // vertically due to gravity, which causes false horizontal collision
+    // detections. So only resolve X collisions if there's significant Y
+    // overlap, preventing the platform we're standing on from acting like a
+    // wall.
+    float yDistance = fabs(w.positionY[ROCKET_HANDLE] - w.positionY[other]);
+    float yOverlap  = fabs(yDistance - (w.colliderHeight[ROCKET_HANDLE] / 2.0f) - (w.colliderHeight[other] / 2.0f));
+
+    if (yOverlap < Y_COLLISION_THRESHOLD) return;
+
+    float xDistance = fabs(w.positionX[ROCKET_HANDLE] - w.positionX[other]);
+    float xOverlap  = fabs(xDistance - (w.colliderWidth[ROCKET_HANDLE] / 2.0f) - (w.colliderWidth[other] / 2.0f));
+
+    if (mRocket.velocityX > 0) {
+        w.positionX[ROCKET_HANDLE] -= xOverlap;
+        mRocket.velocityX  = 0;
+        mRocket.isCollidingRight = true;
+    } else if (mRocket.velocityX < 0) {
+        w.positionX[ROCKET_HANDLE] += xOverlap;
+        mRocket.velocityX  = 0;
+        mRocket.isCollidingLeft = true;
+    }
+}
+
+void Simulation::resetColliderFlags()
+{
+    mRocket.isCollidingTop    = false;
+    mRocket.isCollidingBottom = false;
+    mRocket.isCollidingRight  = false;
+    mRocket.isCollidingLeft   = false;
+}
+
+void Simulation::endGame(GameOverReason reason)
+{
+    mGameOverReason = reason;
+    mIsGameOver     = true;
+
+    mEvents.push_back({ GAME_OVER, ROCKET_HANDLE, reason });
+}
+
+/**
+ * Notes that the rocket touched `pad` this step, once however many ways it
+ * touched it.
+ */
+void Simulation::emitContact(EntityHandle pad)
+{
+    for (size_t i = 0; i < mEvents.size(); i++)
+        if (mEvents[i].type == PAD_CONTACT && mEvents[i].pad == pad) return;
+
+    mEvents.push_back({ PAD_CONTACT, pad, OUT_OF_BOUNDS });
+}
+
+/**
+ * Advances the whole world by one step: moving pads first, then the rocket
+ * against the pads' new positions. The positions from before the step are
+ * kept so the renderer can interpolate between the last two states, and
+ * the last step's events are dropped for this one's.
+ *
+ * @param deltaTime the step length in seconds. Callers are expected to pass
+ * a fixed timestep.
+ */
+void Simulation::step(float deltaTime)
+{
+    PROFILE_SCOPE("Simulation::step");
+
+    mEvents.clear();
+
+    mRocket.previousPositionX = mWorld.positionX[ROCKET_HANDLE];
+    mRocket.previousPositionY = mWorld.positionY[ROCKET_HANDLE];
+
+    updateLandingPads(deltaTime);
+    updateRocket(deltaTime);
+}
+
+void Simulation::updateLandingPads(float deltaTime)
+{
+    // Fixed pads never move, so only the moving ones are visited
+    MovingPads &movingPads = mWorld.movingPads;
+
+    float              *positionX = mWorld.positionX.data();
+    const EntityHandle *handle    = movingPads.handle.data();
+    float              *previousX = movingPads.previousX.data();
+    float              *velocityX = movingPads.velocityX.data();
+    const float        *anchorX   = movingPads.anchorX.data();
+
+    for (int i = 0; i < movingPads.size(); i++) previousX[i] = positionX[handle[i]];
+
+    if (mIsGameOver) return;
+
+    for (int i = 0; i < movingPads.size(); i++)
+    {
+        float x = previousX[i] + velocityX[i] * deltaTime;
+
+        if (x > anchorX[i] + LANDING_PAD_TRAVEL ||
+            x < anchorX[i] - LANDING_PAD_TRAVEL) {
+            velocityX[i] = -velocityX[i];
+        }
+
+        positionX[handle[i]] = x;
+    }
+}
+
+void Simulation::resolveCollisions()
+{
+    PROFILE_SCOPE("collision");
+
+    // The broadphase narrows the level down to the pads under the rocket;
+    // only those get the exact overlap test and resolution
+    mBroadphase.update(mWorld, ROCKET_HANDLE + 1);
+    mBroadphase.findPairs(mWorld, ROCKET_HANDLE);
+
+    const std::vector<CollisionPair> &pairs = mBroadphase.getPairs();
+    for (size_t i = 0; i < pairs.size(); i++) {
+        if (!isColliding(pairs[i].other)) continue;
+
+        emitContact(pairs[i].other);
+        checkCollisionY(pairs[i].other);
+        checkCollisionX(pairs[i].other);
+    }
+}
+
+/**
+ * Catches pads the rocket would have passed straight through this step.
+ * Overlap tests only look at where things end up, so a rocket moving more
+ * than a pad's thickness in one step can tunnel through it; this instead
+ * finds the first moment along the step that the rocket's box touches a
+ * pad's, with both moving, and pulls the rocket back to that point on the
+ * axis it hit, just inside the pad. The usual overlap resolution takes it
+ * from there on the next step.
+ *
+ * Works in each pad's frame of reference: the rocket's motion relative to
+ * the pad is a straight line, tested against the pad grown by the rocket's
+ * half-size on each side (slab test). Pads the rocket started the step
+ * overlapping are left to the overlap resolution.
+ *
+ * @param start where the rocket was before this step's integration.
+ *
+ * @return `true` if the rocket hit something and was moved back.
+ */
+bool Simulation::sweepRocket(Vector2 start, float deltaTime)
+{
+    PROFILE_SCOPE("sweep");
+
+    const EntityWorld &w = mWorld;
+
+    mBroadphase.findSweptPairs(w, ROCKET_HANDLE, start, LANDING_PAD_SPEED * deltaTime);
+
+    float firstHit = INFINITY;
+    EntityHandle hitPad = ROCKET_HANDLE;
+    bool hitOnX = false;
+
+    const std::vector<CollisionPair> &pairs = mBroadphase.getPairs();
+    for (size_t i = 0; i < pairs.size(); i++)
+    {
+        EntityHandle pad = pairs[i].other;
+
+        float halfWidth  = (w.colliderWidth[ROCKET_HANDLE]  + w.colliderWidth[pad])  / 2.0f;
+        float halfHeight = (w.colliderHeight[ROCKET_HANDLE] + w.colliderHeight[pad]) / 2.0f;
+
+        Vector2 padStart = w.getPreviousPosition(pad);
+
+        float startX = start.x - padStart.x;
+        float startY = start.y - padStart.y;
+
+        if (fabsf(startX) < halfWidth && fabsf(startY) < halfHeight) continue;
+
+        float endX = w.positionX[ROCKET_HANDLE] - w.positionX[pad];
+        float endY = w.positionY[ROCKET_HANDLE] - w.positionY[pad];
+
+        // Most pads are nowhere near: the whole step stays off to one side
+        if ((startX >= halfWidth  && endX >= halfWidth)  || (startX <= -halfWidth  && endX <= -halfWidth) ||
+            (startY >= halfHeight && endY >= halfHeight) || (startY <= -halfHeight && endY <= -halfHeight))
+            continue;
+
+        float travelX = endX - startX;
+        float travelY = endY - startY;
+
+        float enterX, exitX, enterY, exitY;
+
+        if (travelX == 0.0f)
+        {
+            if (fabsf(startX) >= halfWidth) continue;
+            enterX = -INFINITY;
+            exitX  =  INFINITY;
+        }
+        else
+        {
+            float nearX = (-copysignf(halfWidth, travelX) - startX) / travelX;
+            float farX  = ( copysignf(halfWidth, travelX) - startX) / travelX;
+            enterX = nearX;
+            exitX  = farX;
+        }
+
+        if (travelY == 0.0f)
+        {
+            if (fabsf(startY) >= halfHeight) continue;
+            enterY = -INFINITY;
+            exitY  =  INFINITY;
+        }
+        else
+        {
+            float nearY = (-copysignf(halfHeight, travelY) - startY) / travelY;
+            float farY  = ( copysignf(halfHeight, travelY) - startY) / travelY;
+            enterY = nearY;
+            exitY  = farY;
+        }
+
+        float enter = fmaxf(enterX, enterY);
+        float exit  = fminf(exitX, exitY);
+
+        if (enter >= exit || enter < 0.0f || enter > 1.0f || enter >= firstHit) continue;
+
+        firstHit = enter;
+        hitPad   = pad;
+        hitOnX   = enterX > enterY;
+    }
+
+    if (hitPad == ROCKET_HANDLE) return false;
+
+    emitContact(hitPad);
+
+    Vector2 hitPadStart = w.getPreviousPosition(hitPad);
+
+    // Only the axis that hit is pulled back, to where it touched (relative
+    // to where the pad is now) plus a nudge inside; motion along the pad's
+    // face is kept, so a rocket sliding across a pad isn't caught on it
+    if (hitOnX)
+    {
+        float startX  = start.x - hitPadStart.x;
+        float travelX = (w.positionX[ROCKET_HANDLE] - w.positionX[hitPad]) - startX;
+
+        mWorld.positionX[ROCKET_HANDLE] = w.positionX[hitPad] + startX + travelX * firstHit +
+            copysignf(SWEEP_CONTACT_DEPTH, travelX);
+    }
+    else
+    {
+        float startY  = start.y - hitPadStart.y;
+        float travelY = (w.positionY[ROCKET_HANDLE] - w.positionY[hitPad]) - startY;
+
+        mWorld.positionY[ROCKET_HANDLE] = w.positionY[hitPad] + startY + travelY * firstHit +
+            copysignf(SWEEP_CONTACT_DEPTH, travelY);
+    }
+
+    return true;
+}
+
+/**
+ * Checks the rocket against the terrain, by looking up the ground under
+ * both of its bottom corners and its middle: three lookups, however finely
+ * the terrain is sampled. A rocket that has reached the ground is put back
+ * on top of it.
+ *
+ * @return `true` if the rocket touched the ground.
+ */
+bool Simulation::checkCollisionTerrain()
+{
+    if (mTerrain.isEmpty()) return false;
+
+    float x          = mWorld.positionX[ROCKET_HANDLE],
+          halfWidth  = mWorld.colliderWidth[ROCKET_HANDLE]  / 2.0f,
+          halfHeight = mWorld.colliderHeight[ROCKET_HANDLE] / 2.0f;
+
+    // Smaller is higher, so the highest of the three is the one to clear
+    float ground = std::min(mTerrain.getHeight(x),
+        std::min(mTerrain.getHeight(x - halfWidth), mTerrain.getHeight(x + halfWidth)));
+
+    if (mWorld.positionY[ROCKET_HANDLE] + halfHeight < ground) return false;
+
+    mWorld.positionY[ROCKET_HANDLE] = ground - halfHeight;
+    return true;
+}
+
+void Simulation::updateRocket(float deltaTime)
+{
+    if (mIsGameOver) return;
+
+    resolveCollisions();
+
+    if (mRocket.isCollidingLeft || mRocket.isCollidingRight || mRocket.isCollidingTop) {
+        endGame(CRASHED);
+    }
+
+    else if (mRocket.isCollidingBottom && fabs(mRocket.velocityX) <= LANDING_SPEED_THRESHOLD) {
+        endGame(LANDED_SUCCESSFULLY);
+    }
+
+    resetColliderFlags();
+
+    if (mRocket.fuelTank <= 0.0f) releaseThrusters();
+
+    mRocket.isThrusting = mRocket.acceleratingUp || mRocket.acceleratingLeft || mRocket.acceleratingRight;
+
+    Vector2 start = getRocketPosition();
+
+    int reason;
+    {
+        PROFILE_SCOPE("integration");
+        reason = integrateLander(deltaTime,
+            mRocket.acceleratingUp, mRocket.acceleratingLeft, mRocket.acceleratingRight,
+            mWorld.positionX[ROCKET_HANDLE], mWorld.positionY[ROCKET_HANDLE],
+            mRocket.velocityX, mRocket.velocityY,
+            mRocket.accelerationX, mRocket.accelerationY,
+            mRocket.fuelTank);
+    }
+
+    // A hit on the way means the rocket never got as far as leaving the map
+    if (sweepRocket(start, deltaTime) && reason == OUT_OF_BOUNDS &&
+        !isOutOfBounds(mWorld.positionX[ROCKET_HANDLE], mWorld.positionY[ROCKET_HANDLE]))
+    {
+        reason = STILL_FLYING;
+    }
+
+    // The ground goes all the way down, so hitting it is a crash whatever
+    // else the integration made of the step
+    if (checkCollisionTerrain()) reason = CRASHED;
+
+    if (reason != STILL_FLYING) endGame((GameOverReason) reason);
+}
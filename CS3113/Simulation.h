@@ -0,0 +1,171 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include "EntityWorld.h"
+#include "Broadphase.h"
+#include "Terrain.h"
+
+#include <math.h>
+
+enum GameOverReason     { OUT_OF_BOUNDS, OUT_OF_FUEL, LANDED_SUCCESSFULLY, CRASHED };
+constexpr int           GAME_OVER_REASON_COUNT = 4;
+constexpr float         GRAVITATIONAL_ACCELERATION = 10.0f,
+                        THRUSTING_ACCELERATION   = 18.0f,
+                        HORIZONTAL_ACCELERATION = 12.0f,
+                        DRAG_CONSTANT = 0.5f;
+
+constexpr float         WORLD_MIN_X = -50.0f,
+                        WORLD_MAX_X = 1550.0f,
+                        WORLD_MIN_Y = -50.0f,
+                        WORLD_MAX_Y = 850.0f;
+
+inline bool isOutOfBounds(float x, float y)
+{
+    return y > WORLD_MAX_Y || y < WORLD_MIN_Y || x < WORLD_MIN_X || x > WORLD_MAX_X;
+}
+
+// Fuel is burned per second of thrust, per thruster, so the drain rate no
+// longer depends on how often input is polled or how many substeps run.
+constexpr float         STARTING_FUEL            = 100.0f,
+                        FUEL_BURN_RATE           = 0.12f,
+                        LANDING_SPEED_THRESHOLD  = 5.0f,
+                        Y_COLLISION_THRESHOLD    = 0.5f,
+                        LANDING_PAD_SPEED        = 50.0f,
+                        LANDING_PAD_TRAVEL       = 500.0f;
+
+// How far a swept hit leaves the rocket inside the pad it hit, so the regular
+// overlap resolution on the next step still sees the contact
+constexpr float         SWEEP_CONTACT_DEPTH      = 0.01f;
+
+// The rocket is always the first entity created after a reset
+constexpr EntityHandle  ROCKET_HANDLE = 0;
+
+/**
+ * Rocket-only state. Its box (position and collider) lives in the
+ * `EntityWorld` under `ROCKET_HANDLE`, like every other body's, so the
+ * broadphase and collision code treat it the same way; everything else it
+ * has that pads don't is here.
+ */
+struct Rocket
+{
+    float previousPositionX;
+    float previousPositionY;
+    float velocityX;
+    float velocityY;
+    float accelerationX;
+    float accelerationY;
+
+    float fuelTank;
+
+    bool isCollidingTop;
+    bool isCollidingBottom;
+    bool isCollidingRight;
+    bool isCollidingLeft;
+
+    bool acceleratingUp;
+    bool acceleratingLeft;
+    bool acceleratingRight;
+
+    bool isThrusting;
+};
+
+enum SimulationEventType { PAD_CONTACT, GAME_OVER };
+
+/**
+ * Something that happened during a step, for whoever cares to react to it.
+ * `PAD_CONTACT` is emitted once per pad the rocket touched (`pad` says
+ * which); `GAME_OVER` is emitted once, on the step the game ends (`reason`
+ * says how).
+ *
+ * `reason` is only meaningful on `GAME_OVER`. Contacts always carry
+ * `OUT_OF_BOUNDS`, the first value, whatever the game's state, so check
+ * `type` before reading it.
+ */
+struct SimulationEvent
+{
+    SimulationEventType type;
+    EntityHandle        pad;
+    GameOverReason      reason;
+};
+
+/**
+ * Headless lunar lander world. Owns the rocket and landing pad state and
+ * advances it one fixed step at a time; nothing in here touches raylib, so it
+ * can be stepped on machines without a window or GL context.
+ *
+ * Fixed pads are never updated at all. Moving pads patrol around their
+ * anchor, and are stepped by one pass over the world's `movingPads`.
+ *
+ * A level can also have a terrain: solid ground under a heightfield line.
+ * The rocket is checked against it by looking up the ground under it, so
+ * how detailed the surface is doesn't change what a step costs. Touching
+ * it anywhere but on a pad is a crash.
+ *
+ * Outcomes are reported as events rather than pushed to anything: each step
+ * starts a fresh event list, and callers read it with `getEvents()` after
+ * the step. Ending the game is one flag and one event however big the
+ * level is.
+ */
+class Simulation
+{
+private:
+    // The microbenchmarks time the collision helpers on their own
+    friend struct SimulationBenchmarks;
+
+    EntityWorld mWorld;
+    Broadphase mBroadphase;
+    Rocket mRocket;
+    Terrain mTerrain;
+
+    bool mIsGameOver;
+    GameOverReason mGameOverReason;
+
+    std::vector<SimulationEvent> mEvents;
+
+    bool isColliding(EntityHandle other) const;
+    void checkCollisionY(EntityHandle other);
+    void checkCollisionX(EntityHandle other);
+    void resetColliderFlags();
+    void resolveCollisions();
+    bool sweepRocket(Vector2 start, float deltaTime);
+    bool checkCollisionTerrain();
+
+    void updateLandingPads(float deltaTime);
+    void updateRocket(float deltaTime);
+    void endGame(GameOverReason reason);
+    void emitContact(EntityHandle pad);
+
+public:
+    Simulation();
+
+    void reset();
+    void reserve(int entityCount) { mWorld.reserve(entityCount); }
+    void setRocket(Vector2 position, Vector2 colliderDimensions);
+    void setRocketVelocity(Vector2 velocity);
+    EntityHandle addLandingPad(Vector2 position, Vector2 colliderDimensions,
+        EntityType entityType);
+    EntityHandle addLandingPads(int count, const float *positionsX, const float *positionsY,
+        const float *colliderWidths, const float *colliderHeights,
+        const unsigned char *entityTypes);
+    void setTerrain(const Terrain &terrain) { mTerrain = terrain; }
+
+    void accelerateUp();
+    void accelerateLeft();
+    void accelerateRight();
+    void releaseThrusters();
+
+    void step(float deltaTime);
+
+    const EntityWorld &getWorld()          const { return mWorld;              }
+    const Rocket      &getRocket()         const { return mRocket;             }
+    const Terrain     &getTerrain()        const { return mTerrain;            }
+    Vector2            getRocketPosition() const { return mWorld.getPosition(ROCKET_HANDLE); }
+    Vector2            getRocketPreviousPosition() const
+        { return { mRocket.previousPositionX, mRocket.previousPositionY }; }
+    Vector2            getRocketVelocity() const { return { mRocket.velocityX, mRocket.velocityY }; }
+    const std::vector<SimulationEvent> &getEvents() const { return mEvents; }
+    bool               isGameOver()        const { return mIsGameOver;         }
+    GameOverReason     getGameOverReason() const { return mGameOverReason;     }
+};
+
+#endif // SIMULATION_H
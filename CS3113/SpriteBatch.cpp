@@ -0,0 +1,132 @@
+#include "SpriteBatch.h"
+
+/**
+ * Returns the bucket for `texture`, opening a new one if this is the first
+ * quad using it this frame. There are only ever a handful of textures in
+ * flight, so a linear search beats hashing.
+ */
+SpriteBatch::Bucket *SpriteBatch::findBucket(Texture2D texture)
+{
+    for (int i = 0; i < mActiveBuckets; i++)
+        if (mBuckets[i].texture.id == texture.id) return &mBuckets[i];
+
+    if (mActiveBuckets == (int) mBuckets.size()) mBuckets.push_back(Bucket());
+
+    Bucket *bucket  = &mBuckets[mActiveBuckets++];
+    bucket->texture = texture;
+    return bucket;
+}
+
+/**
+ * Queues one sprite. Takes the same arguments as raylib's `DrawTexturePro()`
+ * and places the quad the same way: `destination`'s x and y are where
+ * `origin` ends up, the quad rotates about that point, and a negative
+ * source width or height flips it.
+ */
+void SpriteBatch::draw(Texture2D texture, Rectangle source, Rectangle destination,
+    Vector2 origin, float rotation, Color tint)
+{
+    if (texture.id == 0) return;
+
+    // Corners relative to the pivot, before rotation
+    float left   = -origin.x,
+          top    = -origin.y,
+          right  = destination.width  - origin.x,
+          bottom = destination.height - origin.y;
+
+    Vector2 corners[4];
+
+    if (rotation == 0.0f)
+    {
+        corners[0] = { destination.x + left,  destination.y + top    };
+        corners[1] = { destination.x + left,  destination.y + bottom };
+        corners[2] = { destination.x + right, destination.y + bottom };
+        corners[3] = { destination.x + right, destination.y + top    };
+    }
+    else
+    {
+        float sine   = sinf(rotation * DEG2RAD),
+              cosine = cosf(rotation * DEG2RAD);
+
+        float xs[4] = { left, left,   right,  right };
+        float ys[4] = { top,  bottom, bottom, top   };
+
+        for (int i = 0; i < 4; i++)
+            corners[i] = {
+                destination.x + xs[i] * cosine - ys[i] * sine,
+                destination.y + xs[i] * sine   + ys[i] * cosine
+            };
+    }
+
+    // Cull against the view using the quad's bounding box
+    float minX = corners[0].x, maxX = corners[0].x,
+          minY = corners[0].y, maxY = corners[0].y;
+    for (int i = 1; i < 4; i++)
+    {
+        minX = fminf(minX, corners[i].x); maxX = fmaxf(maxX, corners[i].x);
+        minY = fminf(minY, corners[i].y); maxY = fmaxf(maxY, corners[i].y);
+    }
+
+    if (maxX < mView.x || minX > mView.x + mView.width ||
+        maxY < mView.y || minY > mView.y + mView.height) return;
+
+    // A negative source size flips the image, as it does for DrawTexturePro()
+    if (source.width  < 0.0f) source.x -= source.width;
+    if (source.height < 0.0f) source.y -= source.height;
+
+    float u0 = source.x / texture.width,
+          v0 = source.y / texture.height,
+          u1 = (source.x + source.width)  / texture.width,
+          v1 = (source.y + source.height) / texture.height;
+
+    Bucket *bucket = findBucket(texture);
+
+    bucket->vertices.push_back({ corners[0].x, corners[0].y, u0, v0 });
+    bucket->vertices.push_back({ corners[1].x, corners[1].y, u0, v1 });
+    bucket->vertices.push_back({ corners[2].x, corners[2].y, u1, v1 });
+    bucket->vertices.push_back({ corners[3].x, corners[3].y, u1, v0 });
+    bucket->tints.push_back(tint);
+}
+
+/**
+ * Submits everything queued since the last flush, one texture at a time, and
+ * empties the batch. Call between `BeginDrawing()` and `EndDrawing()`.
+ */
+void SpriteBatch::flush()
+{
+    for (int i = 0; i < mActiveBuckets; i++)
+    {
+        Bucket &bucket = mBuckets[i];
+        int quadCount  = (int) bucket.tints.size();
+
+        // Make sure the whole bucket fits in rlgl's current batch, so it goes
+        // out as a single draw instead of being split at an arbitrary point
+        rlCheckRenderBatchLimit(quadCount * 4);
+
+        rlSetTexture(bucket.texture.id);
+        rlBegin(RL_QUADS);
+
+            rlNormal3f(0.0f, 0.0f, 1.0f);
+
+            for (int quad = 0; quad < quadCount; quad++)
+            {
+                const Color &tint = bucket.tints[quad];
+                rlColor4ub(tint.r, tint.g, tint.b, tint.a);
+
+                for (int corner = 0; corner < 4; corner++)
+                {
+                    const SpriteVertex &vertex = bucket.vertices[quad * 4 + corner];
+                    rlTexCoord2f(vertex.u, vertex.v);
+                    rlVertex2f(vertex.x, vertex.y);
+                }
+            }
+
+        rlEnd();
+        rlSetTexture(0);
+
+        bucket.vertices.clear();
+        bucket.tints.clear();
+    }
+
+    mActiveBuckets = 0;
+}
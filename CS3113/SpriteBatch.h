@@ -0,0 +1,49 @@
+#ifndef SPRITE_BATCH_H
+#define SPRITE_BATCH_H
+
+#include "cs3113.h"
+
+/**
+ * Collects textured quads over a frame and submits them grouped by texture,
+ * one rlgl draw per texture rather than one `DrawTexturePro()` per sprite.
+ *
+ * Quads that fall entirely outside the view are dropped on the way in.
+ * Buckets keep their storage between frames, so after the first few frames
+ * gathering sprites doesn't allocate.
+ *
+ * rlgl's own vertex buffer has a fixed size (8192 quads by default); a
+ * texture with more visible quads than that still gets split across draws.
+ */
+class SpriteBatch
+{
+private:
+    struct SpriteVertex
+    {
+        float x, y;
+        float u, v;
+    };
+
+    struct Bucket
+    {
+        Texture2D                 texture;
+        std::vector<SpriteVertex> vertices; // four per quad
+        std::vector<Color>        tints;    // one per quad
+    };
+
+    std::vector<Bucket> mBuckets;
+    int                 mActiveBuckets = 0;
+    Rectangle           mView;
+
+    Bucket *findBucket(Texture2D texture);
+
+public:
+    SpriteBatch(Rectangle view) : mView {view} {}
+
+    void draw(Texture2D texture, Rectangle source, Rectangle destination,
+        Vector2 origin, float rotation, Color tint);
+    void flush();
+
+    void setView(Rectangle view) { mView = view; }
+};
+
+#endif // SPRITE_BATCH_H
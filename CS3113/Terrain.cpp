@@ -0,0 +1,141 @@
+#include "Terrain.h"
+#include "Random.h"
+
+#include <algorithm>
+#include <math.h>
+
+// The broadest octave's features are this wide; each octave after it is
+// half as wide and half as tall
+constexpr int   TERRAIN_OCTAVES          = 4;
+constexpr float TERRAIN_WAVELENGTH       = 480.0f;
+
+// One crater per this much surface, each this wide across its bowl
+constexpr float CRATER_SPACING           = 300.0f,
+                CRATER_MIN_RADIUS        = 30.0f,
+                CRATER_MAX_RADIUS        = 90.0f;
+
+namespace
+{
+    // A repeatable value in [-1, 1] for lattice point `i` of `octave`
+    float getLatticeValue(unsigned int seed, int octave, int i)
+    {
+        unsigned int hash = mixSeed(seed, (unsigned int) octave * 0x10000u + (unsigned int) i);
+        return (hash >> 8) * (2.0f / 16777216.0f) - 1.0f;
+    }
+
+    // Smoothstep value noise: lattice values eased into each other
+    float getNoise(unsigned int seed, int octave, float x)
+    {
+        float lattice  = floorf(x);
+        float fraction = x - lattice;
+        float ease     = fraction * fraction * (3.0f - 2.0f * fraction);
+
+        float a = getLatticeValue(seed, octave, (int) lattice),
+              b = getLatticeValue(seed, octave, (int) lattice + 1);
+        return a + (b - a) * ease;
+    }
+
+    /**
+     * How far a crater at `distance` from its centre (in radii) moves the
+     * ground, as a fraction of its depth: down into the bowl inside, up
+     * over the rim around the edge, and nothing well outside.
+     */
+    float getCraterProfile(float distance)
+    {
+        constexpr float RIM_CENTRE = 1.1f,
+                        RIM_WIDTH  = 0.35f,
+                        RIM_HEIGHT = 0.3f;
+
+        float bowl = distance < 1.0f ? 1.0f - distance * distance : 0.0f;
+        float rim  = std::max(0.0f, 1.0f - fabsf(distance - RIM_CENTRE) / RIM_WIDTH);
+
+        return bowl - RIM_HEIGHT * rim;
+    }
+}
+
+Terrain::Terrain() :
+    mMinX{0.0f},
+    mSpacing{1.0f},
+    mInverseSpacing{1.0f},
+    mSeed{0},
+    mBaseY{0.0f},
+    mAmplitude{0.0f}
+{
+}
+
+/**
+ * Builds a surface from `minX` to `maxX` with a sample every `spacing`:
+ * rolling hills from a few octaves of value noise, pocked with craters. It
+ * stays within `amplitude` of `baseY` either way, so the highest it can
+ * ever reach is `baseY - amplitude`.
+ *
+ * The same arguments always build the same surface. Replaces whatever was
+ * generated before, reusing its storage.
+ */
+void Terrain::generate(unsigned int seed, float minX, float maxX, float spacing,
+    float baseY, float amplitude)
+{
+    int sampleCount = (int) ceilf((maxX - minX) / spacing) + 1;
+
+    mMinX           = minX;
+    mSpacing        = spacing;
+    mInverseSpacing = 1.0f / spacing;
+    mSeed           = seed;
+    mBaseY          = baseY;
+    mAmplitude      = amplitude;
+
+    mHeights.assign(sampleCount, baseY);
+
+    // Octave heights sum to just under twice the first's, so the first gets
+    // half the amplitude and the hills alone stay in range
+    float wavelength = TERRAIN_WAVELENGTH,
+          height     = amplitude * 0.5f;
+
+    for (int octave = 0; octave < TERRAIN_OCTAVES; octave++)
+    {
+        for (int i = 0; i < sampleCount; i++)
+            mHeights[i] += height * getNoise(seed, octave, (minX + i * spacing) / wavelength);
+
+        wavelength *= 0.5f;
+        height     *= 0.5f;
+    }
+
+    Random random(mixSeed(seed, TERRAIN_OCTAVES));
+    int craterCount = (int) ((maxX - minX) / CRATER_SPACING);
+
+    for (int crater = 0; crater < craterCount; crater++)
+    {
+        float centre = random.nextFloat(minX, maxX),
+              radius = random.nextFloat(CRATER_MIN_RADIUS, CRATER_MAX_RADIUS),
+              depth  = radius * 0.3f;
+
+        // Only the samples within reach of the rim are touched
+        int first = std::max(0,               (int) ((centre - radius * 1.5f - minX) * mInverseSpacing)),
+            last  = std::min(sampleCount - 1, (int) ((centre + radius * 1.5f - minX) * mInverseSpacing) + 1);
+
+        for (int i = first; i <= last; i++)
+            mHeights[i] += depth * getCraterProfile(fabsf(minX + i * spacing - centre) / radius);
+    }
+
+    for (int i = 0; i < sampleCount; i++)
+        mHeights[i] = std::min(std::max(mHeights[i], baseY - amplitude), baseY + amplitude);
+}
+
+/**
+ * Presses a level stretch into the surface at height `y` from `left` to
+ * `right`, for a pad to sit on, blending back into the surface around it
+ * over `shoulder` either side.
+ */
+void Terrain::flatten(float left, float right, float y, float shoulder)
+{
+    for (int i = 0; i < (int) mHeights.size(); i++)
+    {
+        float x = mMinX + i * mSpacing;
+
+        float distance = x < left ? left - x : (x > right ? x - right : 0.0f);
+        if (distance > shoulder) continue;
+
+        float weight = shoulder > 0.0f ? 1.0f - distance / shoulder : 1.0f;
+        mHeights[i] += (y - mHeights[i]) * weight;
+    }
+}
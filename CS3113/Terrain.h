@@ -0,0 +1,67 @@
+#ifndef TERRAIN_H
+#define TERRAIN_H
+
+#include <vector>
+
+/**
+ * The lunar surface, as a heightfield: the ground's y at evenly spaced x,
+ * with straight lines between samples. Everything below the line is solid.
+ * Like the rest of the world, y grows downwards, so higher ground has a
+ * smaller height.
+ *
+ * Finding the ground under any x is one index and one interpolation however
+ * many samples there are, so the surface can be as wide and as detailed as
+ * we like without collisions against it costing any more.
+ *
+ * The surface is generated from a seed and two numbers, so that's all a
+ * level stores; the samples are rebuilt on load. Flat stretches for the
+ * pads to sit on are pressed in afterwards with `flatten()`.
+ */
+class Terrain
+{
+private:
+    std::vector<float> mHeights;
+    float              mMinX;
+    float              mSpacing;
+    float              mInverseSpacing;
+
+    // What it was generated from, so a level can be written back out
+    unsigned int       mSeed;
+    float              mBaseY;
+    float              mAmplitude;
+
+public:
+    Terrain();
+
+    void generate(unsigned int seed, float minX, float maxX, float spacing,
+        float baseY, float amplitude);
+    void flatten(float left, float right, float y, float shoulder);
+    void clear() { mHeights.clear(); }
+
+    /**
+     * The ground's y under `x`. Beyond either end the surface carries on
+     * level with the last sample.
+     */
+    float getHeight(float x) const
+    {
+        float position = (x - mMinX) * mInverseSpacing;
+        if (position <= 0.0f) return mHeights.front();
+
+        int sample = (int) position;
+        if (sample >= (int) mHeights.size() - 1) return mHeights.back();
+
+        float fraction = position - sample;
+        return mHeights[sample] + (mHeights[sample + 1] - mHeights[sample]) * fraction;
+    }
+
+    bool         isEmpty()        const { return mHeights.empty();        }
+    int          getSampleCount() const { return (int) mHeights.size();   }
+    const float *getHeights()     const { return mHeights.data();         }
+    float        getMinX()        const { return mMinX;                   }
+    float        getSpacing()     const { return mSpacing;                }
+    unsigned int getSeed()        const { return mSeed;                   }
+    float        getBaseY()       const { return mBaseY;                  }
+    float        getAmplitude()   const { return mAmplitude;              }
+};
+
+#endif // TERRAIN_H
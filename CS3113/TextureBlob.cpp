@@ -0,0 +1,176 @@
+#include "TextureBlob.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+    /**
+     * Bytes per pixel for the uncompressed `PixelFormat`s an image can
+     * decode to, which keep the same values across raylib versions (1 is
+     * grayscale through to 7, R8G8B8A8), or 0 for anything else.
+     */
+    uint64_t getBytesPerPixel(uint32_t format)
+    {
+        static const uint64_t BYTES_PER_PIXEL[] = { 0, 1, 2, 2, 3, 2, 2, 4 };
+        return format < sizeof(BYTES_PER_PIXEL) / sizeof(BYTES_PER_PIXEL[0]) ?
+            BYTES_PER_PIXEL[format] : 0;
+    }
+
+    /**
+     * Whether an entry's pixels are exactly what its size, format and
+     * dimensions say, so building an image from them can't read past them.
+     */
+    bool hasConsistentSize(const TextureBlobEntry &entry)
+    {
+        uint64_t bytesPerPixel = getBytesPerPixel(entry.format);
+        uint64_t pixelCount    = (uint64_t) entry.width * entry.height;
+
+        // Every format takes at least a byte a pixel, so this also keeps the
+        // multiply below from overflowing
+        return bytesPerPixel != 0 && pixelCount <= entry.size &&
+            pixelCount * bytesPerPixel == entry.size;
+    }
+}
+
+TextureBlob::TextureBlob() : mData{nullptr}, mSize{0}
+{
+}
+
+TextureBlob::~TextureBlob()
+{
+    close();
+}
+
+/**
+ * Maps the blob at `filepath`, replacing whatever was open before.
+ *
+ * @return `false` if the file can't be mapped, isn't a texture blob, or any
+ * entry points past its end or has pixels that don't match its format and
+ * dimensions.
+ */
+bool TextureBlob::open(const char *filepath)
+{
+    close();
+
+    int descriptor = ::open(filepath, O_RDONLY);
+    if (descriptor < 0) return false;
+
+    struct stat status;
+    if (fstat(descriptor, &status) != 0 || (size_t) status.st_size < sizeof(TextureBlobHeader))
+    {
+        ::close(descriptor);
+        return false;
+    }
+
+    void *mapping = mmap(nullptr, (size_t) status.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    ::close(descriptor);
+
+    if (mapping == MAP_FAILED) return false;
+
+    mData = (const unsigned char *) mapping;
+    mSize = (size_t) status.st_size;
+
+    const TextureBlobHeader &header = *(const TextureBlobHeader *) mData;
+    bool isValid = memcmp(header.magic, TEXTURE_BLOB_MAGIC, sizeof(header.magic)) == 0 &&
+        header.version == TEXTURE_BLOB_VERSION &&
+        (mSize - sizeof(TextureBlobHeader)) / sizeof(TextureBlobEntry) >= header.textureCount;
+
+    for (uint32_t i = 0; isValid && i < header.textureCount; i++)
+    {
+        const TextureBlobEntry &entry = getEntry((int) i);
+        isValid = entry.offset <= mSize && entry.size <= mSize - entry.offset &&
+            hasConsistentSize(entry) &&
+            memchr(entry.filepath, '\0', sizeof(entry.filepath)) != nullptr;
+    }
+
+    if (!isValid)
+    {
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+void TextureBlob::close()
+{
+    if (mData != nullptr) munmap((void *) mData, mSize);
+
+    mData = nullptr;
+    mSize = 0;
+}
+
+/**
+ * @return the entry baked from `filepath`, or `nullptr` if there isn't one.
+ * Blobs hold a handful of textures, so this is a linear search.
+ */
+const TextureBlobEntry *TextureBlob::find(const char *filepath) const
+{
+    if (mData == nullptr) return nullptr;
+
+    for (int i = 0; i < getTextureCount(); i++)
+        if (strcmp(getEntry(i).filepath, filepath) == 0) return &getEntry(i);
+
+    return nullptr;
+}
+
+/**
+ * Writes `textures` out as a blob, pixels aligned to
+ * `TEXTURE_BLOB_ALIGNMENT`.
+ *
+ * @return `false` if a path is too long to store or the file couldn't be
+ * written.
+ */
+bool writeTextureBlob(const char *filepath, const std::vector<BakedTexture> &textures)
+{
+    TextureBlobHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, TEXTURE_BLOB_MAGIC, sizeof(header.magic));
+    header.version      = TEXTURE_BLOB_VERSION;
+    header.textureCount = (uint32_t) textures.size();
+
+    std::vector<TextureBlobEntry> entries(textures.size());
+    uint64_t offset = sizeof(TextureBlobHeader) + sizeof(TextureBlobEntry) * textures.size();
+
+    for (size_t i = 0; i < textures.size(); i++)
+    {
+        TextureBlobEntry &entry = entries[i];
+        memset(&entry, 0, sizeof(entry));
+
+        if (strlen(textures[i].filepath) >= sizeof(entry.filepath)) return false;
+        strcpy(entry.filepath, textures[i].filepath);
+
+        offset = (offset + TEXTURE_BLOB_ALIGNMENT - 1) / TEXTURE_BLOB_ALIGNMENT * TEXTURE_BLOB_ALIGNMENT;
+
+        entry.width  = (uint32_t) textures[i].width;
+        entry.height = (uint32_t) textures[i].height;
+        entry.format = (uint32_t) textures[i].format;
+        entry.offset = offset;
+        entry.size   = textures[i].size;
+
+        offset += entry.size;
+    }
+
+    FILE *file = fopen(filepath, "wb");
+    if (file == nullptr) return false;
+
+    bool written = fwrite(&header, sizeof(header), 1, file) == 1 &&
+        fwrite(entries.data(), sizeof(TextureBlobEntry), entries.size(), file) == entries.size();
+
+    for (size_t i = 0; written && i < textures.size(); i++)
+    {
+        // Pad up to the pixels' aligned offset
+        static const unsigned char zeroes[TEXTURE_BLOB_ALIGNMENT] = {};
+        long padding = (long) entries[i].offset - ftell(file);
+
+        written = (padding == 0 || fwrite(zeroes, 1, (size_t) padding, file) == (size_t) padding) &&
+            fwrite(textures[i].pixels, 1, textures[i].size, file) == textures[i].size;
+    }
+
+    return fclose(file) == 0 && written;
+}
@@ -0,0 +1,91 @@
+#ifndef TEXTURE_BLOB_H
+#define TEXTURE_BLOB_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+constexpr char     TEXTURE_BLOB_MAGIC[4] = { 'L', 'L', 'T', 'X' };
+constexpr uint32_t TEXTURE_BLOB_VERSION  = 1;
+
+// Pixel data starts on a boundary this wide, so uploads read aligned memory
+constexpr uint64_t TEXTURE_BLOB_ALIGNMENT = 64;
+
+/**
+ * Baked textures: the assets already decoded into the pixels the GPU takes,
+ * so loading them is a memory map and an upload with no decompression.
+ *
+ * The file is this header, then one `TextureBlobEntry` per texture, then
+ * each texture's pixels at its entry's offset. Formats are raylib's
+ * `PixelFormat` values. Like the other binary formats, blobs are written
+ * as-is and only load on the byte order they were baked on.
+ */
+struct TextureBlobHeader
+{
+    char     magic[4];
+    uint32_t version;
+    uint32_t textureCount;
+    uint32_t reserved;
+};
+
+struct TextureBlobEntry
+{
+    // The path the texture was baked from, which is also the name it's
+    // looked up by
+    char     filepath[120];
+    uint32_t width;
+    uint32_t height;
+    uint32_t format;
+    uint32_t reserved;
+    uint64_t offset;
+    uint64_t size;
+};
+
+/**
+ * A decoded texture on its way into a blob. Only borrowed; nothing is
+ * copied until the blob is written.
+ */
+struct BakedTexture
+{
+    const char *filepath;
+    int         width;
+    int         height;
+    int         format;
+    const void *pixels;
+    size_t      size;
+};
+
+/**
+ * Read-only, memory-mapped view of a texture blob. Pixels point straight
+ * into the mapping and stay valid until `close()`.
+ */
+class TextureBlob
+{
+private:
+    const unsigned char *mData;
+    size_t               mSize;
+
+public:
+    TextureBlob();
+    ~TextureBlob();
+
+    TextureBlob(const TextureBlob &) = delete;
+    TextureBlob &operator=(const TextureBlob &) = delete;
+
+    bool open(const char *filepath);
+    void close();
+    bool isOpen() const { return mData != nullptr; }
+
+    const TextureBlobEntry *find(const char *filepath) const;
+
+    int getTextureCount() const
+        { return (int) ((const TextureBlobHeader *) mData)->textureCount; }
+    const TextureBlobEntry &getEntry(int index) const
+        { return ((const TextureBlobEntry *) (mData + sizeof(TextureBlobHeader)))[index]; }
+    const void *getPixels(const TextureBlobEntry &entry) const
+        { return mData + entry.offset; }
+};
+
+bool writeTextureBlob(const char *filepath, const std::vector<BakedTexture> &textures);
+
+#endif // TEXTURE_BLOB_H
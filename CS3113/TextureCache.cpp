@@ -0,0 +1,78 @@
+#include "TextureCache.h"
+
+std::map<std::string, TextureCache::Entry>  TextureCache::sEntries;
+std::map<unsigned int, std::string>         TextureCache::sPathsById;
+
+/**
+ * Returns the texture for `filepath`, loading it only if nobody else holds
+ * it yet.
+ *
+ * @param filepath path of the image to load, used as the cache key as-is.
+ */
+Texture2D TextureCache::acquire(const char *filepath)
+{
+    std::map<std::string, Entry>::iterator found = sEntries.find(filepath);
+
+    if (found != sEntries.end())
+    {
+        found->second.referenceCount++;
+        return found->second.texture;
+    }
+
+    Entry entry;
+    entry.texture        = LoadTexture(filepath);
+    entry.referenceCount = 1;
+
+    // A failed load comes back with id 0; keep it cached so we don't retry
+    // every time, but don't let it be looked up (and unloaded) by id
+    sEntries[filepath] = entry;
+    if (entry.texture.id != 0) sPathsById[entry.texture.id] = filepath;
+
+    return entry.texture;
+}
+
+/**
+ * Caches a texture that was already loaded, as though `acquire()` had just
+ * loaded it. If the path is already cached, the new copy is unloaded and the
+ * cached one shared instead.
+ *
+ * @return the texture now cached for `filepath`; the caller holds one
+ * reference to it and must `release()` it.
+ */
+Texture2D TextureCache::insert(const char *filepath, Texture2D texture)
+{
+    std::map<std::string, Entry>::iterator found = sEntries.find(filepath);
+
+    if (found != sEntries.end())
+    {
+        UnloadTexture(texture);
+        found->second.referenceCount++;
+        return found->second.texture;
+    }
+
+    Entry entry;
+    entry.texture        = texture;
+    entry.referenceCount = 1;
+
+    sEntries[filepath] = entry;
+    if (texture.id != 0) sPathsById[texture.id] = filepath;
+
+    return texture;
+}
+
+/**
+ * Drops one reference to a texture handed out by `acquire()`, unloading it
+ * once nobody holds it. Textures the cache doesn't know about are ignored.
+ */
+void TextureCache::release(Texture2D texture)
+{
+    std::map<unsigned int, std::string>::iterator path = sPathsById.find(texture.id);
+    if (path == sPathsById.end()) return;
+
+    std::map<std::string, Entry>::iterator found = sEntries.find(path->second);
+    if (--found->second.referenceCount > 0) return;
+
+    UnloadTexture(found->second.texture);
+    sEntries.erase(found);
+    sPathsById.erase(path);
+}
@@ -0,0 +1,38 @@
+#ifndef TEXTURE_CACHE_H
+#define TEXTURE_CACHE_H
+
+#include "cs3113.h"
+
+/**
+ * Process-wide, reference-counted texture store keyed by file path. The first
+ * `acquire()` of a path loads it; later ones hand back the same GPU texture.
+ * Each `acquire()` must be paired with a `release()`, and the texture is
+ * unloaded when the last holder lets go.
+ *
+ * Textures loaded some other way (see `AssetLoader`) can be handed to the
+ * cache with `insert()`, after which they're shared like any other.
+ *
+ * Like `LoadTexture()`, this needs a live window, and everything should be
+ * released before `CloseWindow()`.
+ */
+class TextureCache
+{
+private:
+    struct Entry
+    {
+        Texture2D texture;
+        int       referenceCount;
+    };
+
+    static std::map<std::string, Entry>  sEntries;
+    static std::map<unsigned int, std::string> sPathsById;
+
+public:
+    static Texture2D acquire(const char *filepath);
+    static void      release(Texture2D texture);
+    static Texture2D insert(const char *filepath, Texture2D texture);
+
+    static int getLoadedCount() { return (int) sEntries.size(); }
+};
+
+#endif // TEXTURE_CACHE_H
@@ -0,0 +1,73 @@
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <atomic>
+
+/**
+ * Hands the newest value from one writer thread to one reader thread without
+ * either ever waiting on the other.
+ *
+ * There are three slots: the writer fills one, the reader reads one, and the
+ * third holds the most recently published value. Publishing swaps the
+ * writer's slot with that middle one, and acquiring swaps the reader's slot
+ * with it if something new has been published since; both are a single
+ * atomic exchange. The reader only ever sees whole values, always the
+ * newest, and values it was too slow to pick up are simply overwritten.
+ *
+ * The slot the writer gets back after publishing holds an older value, so
+ * everything in it must be rewritten before the next publish. Before either
+ * thread starts, every slot should be filled through `getSlots()` with a
+ * valid value, which is what the reader sees until the first publish.
+ */
+template <typename T>
+class TripleBuffer
+{
+private:
+    // Set alongside the middle slot's index when it holds a value the reader
+    // hasn't taken yet
+    static constexpr int FRESH      = 4;
+    static constexpr int INDEX_MASK = 3;
+
+    T                mSlots[3];
+    int              mWriting;
+    int              mReading;
+    std::atomic<int> mMiddle;
+
+public:
+    static constexpr int SLOT_COUNT = 3;
+
+    TripleBuffer() : mWriting{0}, mReading{1}, mMiddle{2} {}
+
+    TripleBuffer(const TripleBuffer &) = delete;
+    TripleBuffer &operator=(const TripleBuffer &) = delete;
+
+    // Writer thread only
+    T &getWriteSlot() { return mSlots[mWriting]; }
+
+    void publish()
+    {
+        mWriting = mMiddle.exchange(mWriting | FRESH, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    /**
+     * Reader thread only. Takes the newest published value, if there is one
+     * the reader hasn't already taken.
+     *
+     * @return `false` if nothing new was published; the read slot is then
+     * left as it was.
+     */
+    bool acquire()
+    {
+        if ((mMiddle.load(std::memory_order_relaxed) & FRESH) == 0) return false;
+
+        mReading = mMiddle.exchange(mReading, std::memory_order_acq_rel) & INDEX_MASK;
+        return true;
+    }
+
+    const T &getReadSlot() const { return mSlots[mReading]; }
+
+    // For filling every slot before the threads start
+    T *getSlots() { return mSlots; }
+};
+
+#endif // TRIPLE_BUFFER_H
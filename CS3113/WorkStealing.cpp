@@ -0,0 +1,109 @@
+#include "WorkStealing.h"
+
+#include <thread>
+#include <vector>
+
+bool WorkStealingScheduler::takeChunk(int worker, long *chunk)
+{
+    Slice &slice = mSlices[worker];
+    std::lock_guard<std::mutex> guard(slice.lock);
+
+    if (slice.next >= slice.end) return false;
+
+    *chunk = slice.next++;
+    return true;
+}
+
+/**
+ * Moves the back half of the first non-empty slice found into the thief's
+ * own (empty) slice. Victims are tried in order starting just after the
+ * thief, so thieves spread out instead of all hitting worker 0.
+ *
+ * @return `false` once every slice is empty, which means all the work has
+ * been claimed.
+ */
+bool WorkStealingScheduler::steal(int thief)
+{
+    for (int offset = 1; offset < mWorkerCount; offset++)
+    {
+        Slice &victim = mSlices[(thief + offset) % mWorkerCount];
+
+        long begin, end;
+        {
+            std::lock_guard<std::mutex> guard(victim.lock);
+
+            long remaining = victim.end - victim.next;
+            if (remaining <= 0) continue;
+
+            // Leave the victim the front half (it's working from the front)
+            // and take the rest; a single chunk just moves over whole
+            begin = victim.next + remaining / 2;
+            end   = victim.end;
+            victim.end = begin;
+        }
+
+        std::lock_guard<std::mutex> guard(mSlices[thief].lock);
+        mSlices[thief].next = begin;
+        mSlices[thief].end  = end;
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * Runs `body` over every item, returning once all of them are done.
+ *
+ * @param itemCount how many items there are.
+ * @param chunkSize how many consecutive items a worker claims at once.
+ * @param threadCount how many threads to run on; the calling thread is one
+ * of them.
+ * @param body called as `body(worker, begin, end)` for each chunk, where
+ * `worker` is in [0, threadCount) and stays the same for everything one
+ * thread runs, so it can index per-worker state without locking.
+ */
+void WorkStealingScheduler::run(long itemCount, long chunkSize, int threadCount,
+    const Body &body)
+{
+    if (itemCount <= 0) return;
+    if (chunkSize < 1)  chunkSize   = 1;
+    if (threadCount < 1) threadCount = 1;
+
+    long chunkCount = (itemCount + chunkSize - 1) / chunkSize;
+
+    mWorkerCount = threadCount;
+    mSlices.reset(new Slice[threadCount]);
+
+    for (int i = 0; i < threadCount; i++)
+    {
+        mSlices[i].next = chunkCount * i / threadCount;
+        mSlices[i].end  = chunkCount * (i + 1) / threadCount;
+    }
+
+    auto work = [&](int worker)
+    {
+        long chunk;
+        for (;;)
+        {
+            if (!takeChunk(worker, &chunk))
+            {
+                // A slice that is mid-steal looks empty to everyone else,
+                // but its thief is about to run it, so giving up here never
+                // strands work
+                if (!steal(worker)) return;
+                continue;
+            }
+
+            long begin = chunk * chunkSize;
+            long end   = begin + chunkSize < itemCount ? begin + chunkSize : itemCount;
+            body(worker, begin, end);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 1; i < threadCount; i++) threads.emplace_back(work, i);
+
+    work(0);
+
+    for (size_t i = 0; i < threads.size(); i++) threads[i].join();
+}
@@ -0,0 +1,46 @@
+#ifndef WORK_STEALING_H
+#define WORK_STEALING_H
+
+#include <functional>
+#include <memory>
+#include <mutex>
+
+/**
+ * Runs a body over the index range [0, itemCount) on a set of threads, handing
+ * work out in fixed-size chunks.
+ *
+ * Each worker starts out owning an equal, contiguous slice of the chunks and
+ * eats it from the front. A worker that runs dry steals the back half of
+ * another worker's remaining slice, so uneven items (episodes that crash in
+ * ten steps next to ones that hover for minutes) still finish together.
+ *
+ * Work never leaves a slice except by stealing, and each slice has its own
+ * lock touched once per chunk, so workers only ever contend when one of them
+ * is out of work.
+ */
+class WorkStealingScheduler
+{
+private:
+    // Padded out to its own cache line so neighbouring workers' slices don't
+    // false-share
+    struct Slice
+    {
+        std::mutex lock;
+        long       next;
+        long       end;
+        char       padding[64];
+    };
+
+    std::unique_ptr<Slice[]> mSlices;
+    int                      mWorkerCount;
+
+    bool takeChunk(int worker, long *chunk);
+    bool steal(int thief);
+
+public:
+    typedef std::function<void(int worker, long begin, long end)> Body;
+
+    void run(long itemCount, long chunkSize, int threadCount, const Body &body);
+};
+
+#endif // WORK_STEALING_H
@@ -0,0 +1,38 @@
+#include "WorldSnapshot.h"
+
+#include <algorithm>
+
+void WorldSnapshot::reserve(const Simulation &simulation)
+{
+    int count = simulation.getWorld().movingPads.size();
+
+    movingPadX.resize(count);
+    movingPadPreviousX.resize(count);
+}
+
+/**
+ * Copies the simulation's current state in. The timestamps are left to the
+ * caller, which knows when the step was due and what input it used.
+ */
+void WorldSnapshot::capture(const Simulation &simulation)
+{
+    const EntityWorld &world      = simulation.getWorld();
+    const MovingPads  &movingPads = world.movingPads;
+    const Rocket      &rocket     = simulation.getRocket();
+
+    rocketPosition         = simulation.getRocketPosition();
+    rocketPreviousPosition = simulation.getRocketPreviousPosition();
+    rocketVelocity         = simulation.getRocketVelocity();
+    fuelTank               = rocket.fuelTank;
+    isThrusting            = rocket.isThrusting;
+    isThrustingUp          = rocket.acceleratingUp;
+    isThrustingLeft        = rocket.acceleratingLeft;
+    isThrustingRight       = rocket.acceleratingRight;
+    isGameOver             = simulation.isGameOver();
+    gameOverReason         = simulation.getGameOverReason();
+
+    for (int i = 0; i < movingPads.size(); i++)
+        movingPadX[i] = world.positionX[movingPads.handle[i]];
+
+    std::copy(movingPads.previousX.begin(), movingPads.previousX.end(), movingPadPreviousX.begin());
+}
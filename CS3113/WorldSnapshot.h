@@ -0,0 +1,48 @@
+#ifndef WORLD_SNAPSHOT_H
+#define WORLD_SNAPSHOT_H
+
+#include "Simulation.h"
+
+#include <stdint.h>
+
+/**
+ * Everything drawing a frame needs from the simulation, copied out after a
+ * step so the renderer never reads state the simulation thread is writing.
+ *
+ * Only what changes during play is copied. The level's layout (every pad's
+ * extents and kind, and fixed pads' positions) is never written once the
+ * level is loaded, so it's read straight from the world instead; only the
+ * moving pads' positions are in here, in `MovingPads` order.
+ *
+ * `reserve()` sizes the arrays for a level once; after that `capture()`
+ * never allocates.
+ */
+struct WorldSnapshot
+{
+    Vector2 rocketPosition;
+    Vector2 rocketPreviousPosition;
+    Vector2 rocketVelocity;
+    float   fuelTank;
+    bool    isThrusting;
+    bool    isThrustingUp;
+    bool    isThrustingLeft;
+    bool    isThrustingRight;
+
+    // Sticky, so a reader that skips snapshots still sees the game end
+    bool           isGameOver;
+    GameOverReason gameOverReason;
+
+    std::vector<float> movingPadX;
+    std::vector<float> movingPadPreviousX;
+
+    // Profiler::now() timestamps: when the last step taken was due, when the
+    // input it used was sampled, and when it actually ran
+    int64_t stepTime;
+    int64_t inputTime;
+    int64_t steppedTime;
+
+    void reserve(const Simulation &simulation);
+    void capture(const Simulation &simulation);
+};
+
+#endif // WORLD_SNAPSHOT_H
@@ -0,0 +1,150 @@
+/**
+* Asset baker. Decodes images once, ahead of time, into a texture blob the
+* game maps and uploads without decompressing anything.
+*
+* Usage: ./bake_app <blob> <image>...
+*        ./bake_app --bench <blob> <image>...
+*
+* Textures are stored as 8-bit RGBA under the path they were baked from,
+* which is the path the game asks for them by.
+*
+* --bench times getting every image's pixels into memory both ways: decoding
+* the images, and mapping the blob and reading its pixels. It uses raylib's
+* image functions but never opens a window, so it runs without a GPU.
+**/
+
+#include "CS3113/TextureBlob.h"
+
+#include "raylib.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+
+constexpr int BENCH_ROUNDS = 20;
+
+int bake(int argc, char *argv[])
+{
+    if (argc < 3)
+    {
+        fprintf(stderr, "usage: %s <blob> <image>...\n", argv[0]);
+        return 1;
+    }
+
+    std::vector<Image>        images;
+    std::vector<BakedTexture> textures;
+
+    for (int i = 2; i < argc; i++)
+    {
+        Image image = LoadImage(argv[i]);
+        if (image.data == nullptr)
+        {
+            fprintf(stderr, "could not decode %s\n", argv[i]);
+            return 1;
+        }
+
+        ImageFormat(&image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+        images.push_back(image);
+
+        BakedTexture texture;
+        texture.filepath = argv[i];
+        texture.width    = image.width;
+        texture.height   = image.height;
+        texture.format   = image.format;
+        texture.pixels   = image.data;
+        texture.size     = (size_t) GetPixelDataSize(image.width, image.height, image.format);
+        textures.push_back(texture);
+    }
+
+    bool isWritten = writeTextureBlob(argv[1], textures);
+    for (Image &image : images) UnloadImage(image);
+
+    if (!isWritten)
+    {
+        fprintf(stderr, "could not write %s\n", argv[1]);
+        return 1;
+    }
+
+    printf("baked %d textures to %s\n", argc - 2, argv[1]);
+    return 0;
+}
+
+int bench(int argc, char *argv[])
+{
+    if (argc < 4)
+    {
+        fprintf(stderr, "usage: %s --bench <blob> <image>...\n", argv[0]);
+        return 1;
+    }
+
+    SetTraceLogLevel(LOG_WARNING);
+
+    // Both sides end with every pixel read once, as an upload would
+    unsigned long checksum = 0;
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (int round = 0; round < BENCH_ROUNDS; round++)
+    {
+        for (int i = 3; i < argc; i++)
+        {
+            Image image = LoadImage(argv[i]);
+            if (image.data == nullptr)
+            {
+                fprintf(stderr, "could not decode %s\n", argv[i]);
+                return 1;
+            }
+
+            const unsigned char *pixels = (const unsigned char *) image.data;
+            int size = GetPixelDataSize(image.width, image.height, image.format);
+            for (int j = 0; j < size; j++) checksum += pixels[j];
+
+            UnloadImage(image);
+        }
+    }
+
+    double decodeSeconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+
+    for (int round = 0; round < BENCH_ROUNDS; round++)
+    {
+        TextureBlob blob;
+        if (!blob.open(argv[2]))
+        {
+            fprintf(stderr, "not a texture blob: %s\n", argv[2]);
+            return 1;
+        }
+
+        for (int i = 3; i < argc; i++)
+        {
+            const TextureBlobEntry *entry = blob.find(argv[i]);
+            if (entry == nullptr)
+            {
+                fprintf(stderr, "%s is not in %s; rebake it\n", argv[i], argv[2]);
+                return 1;
+            }
+
+            const unsigned char *pixels = (const unsigned char *) blob.getPixels(*entry);
+            for (uint64_t j = 0; j < entry->size; j++) checksum += pixels[j];
+        }
+    }
+
+    double bakedSeconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+
+    printf("textures:            %d\n", argc - 3);
+    printf("decoded:             %.3f ms per load\n", decodeSeconds * 1e3 / BENCH_ROUNDS);
+    printf("baked:               %.3f ms per load\n", bakedSeconds * 1e3 / BENCH_ROUNDS);
+    printf("speed-up:            %.1fx\n", decodeSeconds / bakedSeconds);
+    printf("checksum:            %lu\n", checksum);
+
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc > 1 && strcmp(argv[1], "--bench") == 0) return bench(argc, argv);
+    return bake(argc, argv);
+}
@@ -0,0 +1,599 @@
+/**
+* Microbenchmarks for the engine's hot paths.
+*
+* Usage: ./bench_app [--filter <substring>] [--csv <path>] [--baseline <path>]
+*
+* Every benchmark reports nanoseconds and heap allocations per operation.
+* --csv writes the same results as `name,ns_per_op,allocs_per_op` lines;
+* --baseline reads such a file from an earlier run and flags anything that
+* got more than 15% slower or started allocating more, exiting non-zero if
+* anything did.
+*
+* The render benchmarks record frames into a command list and submit them
+* to the null backend, and also report how many GPU state changes sorting
+* saves. Before any of it runs, the same world is recorded twice and the two
+* lists diffed, and submitted to check the counts; if either check fails,
+* it says why and exits non-zero.
+*
+* The terrain benchmarks look up the ground, alone and as part of a step, at
+* a coarse and a very fine sample spacing; the two should cost the same.
+* The particle benchmarks step a full pool of 100k particles, vectorised
+* and one at a time.
+*
+* Needs raylib's headers (for the cs3113 helpers' types) but never calls into
+* raylib, so it runs without a window or GPU.
+**/
+
+#include "CS3113/cs3113.h"
+#include "CS3113/Simulation.h"
+#include "CS3113/LanderBatch.h"
+#include "CS3113/Level.h"
+#include "CS3113/AllocationCounter.h"
+#include "CS3113/RenderCommands.h"
+#include "CS3113/ParticleSystem.h"
+
+#include <algorithm>
+#include <chrono>
+#include <stdlib.h>
+#include <string.h>
+
+// Keeps the optimiser from deleting work whose result is never used
+template <typename T>
+inline void keep(T const &value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+constexpr double TARGET_SECONDS = 0.1;
+constexpr int    REPETITIONS    = 5;
+constexpr double REGRESSION_THRESHOLD = 1.15;
+
+/**
+ * Lets the benchmarks call `Simulation`'s private collision helpers
+ * directly.
+ */
+struct SimulationBenchmarks
+{
+    static bool isColliding(const Simulation &simulation, EntityHandle other)
+        { return simulation.isColliding(other); }
+    static void checkCollisionY(Simulation *simulation, EntityHandle other)
+        { simulation->checkCollisionY(other); }
+    static void checkCollisionX(Simulation *simulation, EntityHandle other)
+        { simulation->checkCollisionX(other); }
+};
+
+struct Result
+{
+    const char *name;
+    double      nanoseconds;
+    double      allocations;
+};
+
+std::vector<Result> gResults;
+const char         *gFilter = nullptr;
+
+/**
+ * Times `operation`, which runs the benchmarked code `iterations` times.
+ * The iteration count is grown until one run takes about `TARGET_SECONDS`,
+ * then the fastest of `REPETITIONS` runs is kept; the fastest is the one
+ * least disturbed by everything else on the machine.
+ */
+template <typename Operation>
+void benchmark(const char *name, Operation operation)
+{
+    if (gFilter != nullptr && strstr(name, gFilter) == nullptr) return;
+
+    typedef std::chrono::steady_clock Clock;
+
+    long iterations = 1;
+    for (;;)
+    {
+        Clock::time_point start = Clock::now();
+        operation(iterations);
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+        if (seconds >= TARGET_SECONDS / 4.0 || iterations >= (1L << 40)) break;
+        iterations *= seconds > 0.0 ? std::min(16.0, TARGET_SECONDS / seconds) : 16.0;
+    }
+
+    double best = INFINITY;
+    long   allocations = 0;
+
+    for (int repetition = 0; repetition < REPETITIONS; repetition++)
+    {
+        long allocationsBefore = getAllocationCount();
+        Clock::time_point start = Clock::now();
+
+        operation(iterations);
+
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        allocations = getAllocationCount() - allocationsBefore;
+
+        best = std::min(best, seconds);
+    }
+
+    Result result = { name, best * 1e9 / iterations, (double) allocations / iterations };
+    gResults.push_back(result);
+
+    printf("%-36s %12.2f ns/op %10.3f allocs/op\n", result.name, result.nanoseconds, result.allocations);
+}
+
+/**
+ * A rocket parked right in the middle of the stock level's first pad, so
+ * every collision helper has real overlap to work on.
+ */
+void loadOverlappingLevel(Simulation *simulation)
+{
+    loadDefaultLevel(simulation, { LANDING_PAD_POSITION.x, LANDING_PAD_POSITION.y - 30.0f });
+}
+
+void runCollisionBenchmarks()
+{
+    Simulation simulation;
+    loadOverlappingLevel(&simulation);
+
+    const EntityHandle pad = ROCKET_HANDLE + 1;
+    const Vector2 position = simulation.getRocketPosition();
+
+    benchmark("Simulation::isColliding", [&](long iterations)
+    {
+        for (long i = 0; i < iterations; i++)
+            keep(SimulationBenchmarks::isColliding(simulation, pad));
+    });
+
+    // Each resolution pushes the rocket out of the pad, so it's put back
+    // every time; that reset is part of the measured cost
+    benchmark("Simulation::checkCollisionY", [&](long iterations)
+    {
+        for (long i = 0; i < iterations; i++)
+        {
+            simulation.setRocket(position, ROCKET_COLLIDER);
+            simulation.setRocketVelocity({ 0.0f, 5.0f });
+            SimulationBenchmarks::checkCollisionY(&simulation, pad);
+            keep(simulation.getRocketPosition());
+        }
+    });
+
+    benchmark("Simulation::checkCollisionX", [&](long iterations)
+    {
+        for (long i = 0; i < iterations; i++)
+        {
+            simulation.setRocket(position, ROCKET_COLLIDER);
+            simulation.setRocketVelocity({ 5.0f, 0.0f });
+            SimulationBenchmarks::checkCollisionX(&simulation, pad);
+            keep(simulation.getRocketPosition());
+        }
+    });
+}
+
+/**
+ * One full step of a world with `landingPads` pads (the stock level when
+ * 0). The rocket is put back at its start, at rest, every step, and never
+ * thrusts (so it can't run dry), so the game never ends and stops the world
+ * stepping.
+ */
+void benchmarkWorldStep(const char *name, int landingPads)
+{
+    Simulation simulation;
+
+    if (landingPads > 0) loadRandomLevel(&simulation, ROCKET_STARTING_POSITION, landingPads, 1);
+    else                 loadDefaultLevel(&simulation, ROCKET_STARTING_POSITION);
+
+    benchmark(name, [&](long iterations)
+    {
+        for (long i = 0; i < iterations; i++)
+        {
+            simulation.setRocket(ROCKET_STARTING_POSITION, ROCKET_COLLIDER);
+            simulation.setRocketVelocity({ 0.0f, 0.0f });
+            simulation.step(1.0f / 60.0f);
+            keep(simulation.getRocketPosition());
+        }
+    });
+}
+
+void runStepBenchmarks()
+{
+    benchmarkWorldStep("Simulation::step (rocket update)", 0);
+    benchmarkWorldStep("Simulation::step 10 pads",         10);
+    benchmarkWorldStep("Simulation::step 1k pads",         1000);
+    benchmarkWorldStep("Simulation::step 100k pads",       100000);
+
+    LanderBatch landers;
+    landers.reset(1000);
+
+    benchmark("LanderBatch::step 1k landers", [&](long iterations)
+    {
+        for (long i = 0; i < iterations; i++)
+        {
+            // Keep every lander flying: the vector path skips finished ones
+            if ((i & 1023) == 0)
+            {
+                landers.reset(1000);
+                for (int k = 0; k < 1000; k++)
+                    landers.setLander(k, ROCKET_STARTING_POSITION, { 0.0f, 0.0f });
+            }
+
+            landers.step(1.0f / 60.0f);
+            keep(landers.getPosition(0));
+        }
+    });
+}
+
+/**
+ * Ground lookups over a surface sampled every `spacing` pixels, at x
+ * positions that wander the whole width so they don't all hit one sample.
+ */
+void benchmarkTerrainHeight(const char *name, float spacing)
+{
+    Terrain terrain;
+    terrain.generate(7, WORLD_MIN_X, WORLD_MAX_X, spacing, 740.0f, 70.0f);
+
+    benchmark(name, [&](long iterations)
+    {
+        float x = WORLD_MIN_X;
+
+        for (long i = 0; i < iterations; i++)
+        {
+            x += 618.034f;
+            if (x > WORLD_MAX_X) x -= WORLD_MAX_X - WORLD_MIN_X;
+
+            keep(terrain.getHeight(x));
+        }
+    });
+}
+
+// A step of the stock level over a surface sampled every `spacing` pixels
+void benchmarkTerrainStep(const char *name, float spacing)
+{
+    Simulation simulation;
+    loadDefaultLevel(&simulation, ROCKET_STARTING_POSITION);
+    addTerrain(&simulation, 7, 740.0f, 70.0f, spacing);
+
+    benchmark(name, [&](long iterations)
+    {
+        for (long i = 0; i < iterations; i++)
+        {
+            simulation.setRocket(ROCKET_STARTING_POSITION, ROCKET_COLLIDER);
+            simulation.setRocketVelocity({ 0.0f, 0.0f });
+            simulation.step(1.0f / 60.0f);
+            keep(simulation.getRocketPosition());
+        }
+    });
+}
+
+void runTerrainBenchmarks()
+{
+    benchmarkTerrainHeight("Terrain::getHeight 16px spacing",    16.0f);
+    benchmarkTerrainHeight("Terrain::getHeight 1/16px spacing",  1.0f / 16.0f);
+    benchmarkTerrainStep("Simulation::step terrain 16px",        16.0f);
+    benchmarkTerrainStep("Simulation::step terrain 1/16px",      1.0f / 16.0f);
+}
+
+void runParticleBenchmarks()
+{
+    constexpr int PARTICLE_COUNT = 100000;
+
+    // Lifetimes long enough that nothing dies while it's being timed, so
+    // every update sees the whole pool
+    ParticleEmitter emitter = {
+        { 750.0f, 400.0f }, { 0.0f, -1.0f }, 3.14159f,
+        10.0f, 100.0f, 1e6f, 2e6f,
+        2.0f, WHITE
+    };
+
+    ParticleSystem particles(PARTICLE_COUNT, 60.0f);
+    particles.emit(emitter, PARTICLE_COUNT);
+
+    benchmark("ParticleSystem::update 100k", [&](long iterations)
+    {
+        for (long i = 0; i < iterations; i++)
+        {
+            particles.update(1.0f / 120.0f);
+            keep(particles.getPosition(0));
+        }
+    });
+
+    benchmark("ParticleSystem::updateScalar 100k", [&](long iterations)
+    {
+        for (long i = 0; i < iterations; i++)
+        {
+            particles.updateScalar(1.0f / 120.0f);
+            keep(particles.getPosition(0));
+        }
+    });
+
+    ParticleSystem burst(PARTICLE_COUNT, 60.0f);
+
+    benchmark("ParticleSystem::emit 1k", [&](long iterations)
+    {
+        for (long i = 0; i < iterations; i++)
+        {
+            if (burst.size() + 1000 > burst.getCapacity()) burst.clear();
+            burst.emit(emitter, 1000);
+            keep(burst.size());
+        }
+    });
+}
+
+/**
+ * Records a frame the way the game does with colliders shown: every pad's
+ * sprite with its collider right after it, then the rocket, the HUD and the
+ * overlay. Textures are made up; nothing here reaches a GPU.
+ */
+void recordFrame(const Simulation &simulation, RenderCommandList *commands)
+{
+    Texture2D padTexture    = { 1, 64, 16, 1, 7 },
+              rocketTexture = { 2, 600, 100, 1, 7 },
+              hudTexture    = { 3, 1500, 800, 1, 7 };
+
+    const EntityWorld &world = simulation.getWorld();
+
+    commands->clear();
+
+    for (int i = 0; i < world.size(); i++)
+    {
+        Rectangle box = {
+            world.positionX[i], world.positionY[i],
+            world.colliderWidth[i], world.colliderHeight[i]
+        };
+
+        commands->drawSprite(i == ROCKET_HANDLE ? LAYER_ENTITIES : LAYER_LEVEL,
+            i == ROCKET_HANDLE ? rocketTexture : padTexture,
+            { 0.0f, 0.0f, 64.0f, 16.0f }, box, { box.width / 2.0f, box.height / 2.0f }, 0.0f, WHITE);
+        commands->drawRectangleLines(LAYER_DEBUG,
+            { box.x - box.width / 2.0f, box.y - box.height / 2.0f, box.width, box.height }, GREEN);
+    }
+
+    commands->drawSprite(LAYER_HUD, hudTexture, { 0.0f, 0.0f, 1500.0f, -800.0f },
+        { 0.0f, 0.0f, 1500.0f, 800.0f }, { 0.0f, 0.0f }, 0.0f, WHITE);
+
+    for (int line = 0; line < 8; line++)
+        commands->drawText(LAYER_OVERLAY, "frame              p50  0.100 ms  p99  0.200 ms",
+            20, 60 + line * 20, 16, YELLOW);
+}
+
+/**
+ * Draw commands are meant to depend on nothing but what's being drawn, so
+ * recording one world twice has to give the same list, and recording it
+ * after a step has to give a different one. Submitted, the frame has to
+ * come to a sprite and a collider per body, a HUD sprite and its text, in
+ * one state change per layer.
+ */
+bool checkRenderCommands()
+{
+    Simulation simulation;
+    loadRandomLevel(&simulation, ROCKET_STARTING_POSITION, 100, 1);
+
+    RenderCommandList first, second;
+    recordFrame(simulation, &first);
+    recordFrame(simulation, &second);
+    first.sort();
+    second.sort();
+
+    int difference = findFirstDifference(first, second);
+    if (difference >= 0)
+    {
+        fprintf(stderr, "render check: recording one world twice differs at command %d\n", difference);
+        return false;
+    }
+
+    simulation.step(1.0f / 60.0f);
+    recordFrame(simulation, &second);
+    second.sort();
+
+    if (findFirstDifference(first, second) < 0)
+    {
+        fprintf(stderr, "render check: a stepped world recorded the same as before the step\n");
+        return false;
+    }
+
+    NullRenderBackend backend;
+    backend.submit(first);
+
+    int bodies = simulation.getWorld().size();
+
+    // Pads, rocket, colliders, HUD, text: each layer is one texture and one
+    // kind of primitive
+    int expectedStateChanges = 5;
+
+    if (backend.getCommandCount(DRAW_SPRITE)          != bodies + 1 ||
+        backend.getCommandCount(DRAW_RECTANGLE_LINES) != bodies     ||
+        backend.getCommandCount(DRAW_TEXT)            != 8          ||
+        backend.getStateChanges()                     != expectedStateChanges)
+    {
+        fprintf(stderr, "render check: submitted %d sprites, %d colliders, %d texts in %d state changes; "
+            "expected %d, %d, 8 in %d\n",
+            backend.getCommandCount(DRAW_SPRITE), backend.getCommandCount(DRAW_RECTANGLE_LINES),
+            backend.getCommandCount(DRAW_TEXT), backend.getStateChanges(),
+            bodies + 1, bodies, expectedStateChanges);
+        return false;
+    }
+
+    return true;
+}
+
+void runRenderBenchmarks()
+{
+    Simulation simulation;
+    loadRandomLevel(&simulation, ROCKET_STARTING_POSITION, 1000, 1);
+
+    RenderCommandList commands;
+    recordFrame(simulation, &commands);
+    int unsortedChanges = countStateChanges(commands);
+    commands.sort();
+
+    if (gFilter == nullptr || strstr("render state changes", gFilter) != nullptr)
+        printf("%-36s %12d unsorted %10d sorted\n", "render state changes 1k pads",
+            unsortedChanges, countStateChanges(commands));
+
+    benchmark("RenderCommandList record+sort 1k pads", [&](long iterations)
+    {
+        for (long i = 0; i < iterations; i++)
+        {
+            recordFrame(simulation, &commands);
+            commands.sort();
+            keep(commands.getCommand(0));
+        }
+    });
+
+    NullRenderBackend backend;
+
+    benchmark("NullRenderBackend::submit 1k pads", [&](long iterations)
+    {
+        for (long i = 0; i < iterations; i++)
+        {
+            backend.submit(commands);
+            keep(backend.getStateChanges());
+        }
+    });
+}
+
+void runHelperBenchmarks()
+{
+    Texture2D atlas = {};
+    atlas.width  = 600;
+    atlas.height = 100;
+
+    benchmark("getUVRectangle", [&](long iterations)
+    {
+        for (long i = 0; i < iterations; i++)
+        {
+            int index = (int) (i % 6);
+            keep(index);
+            keep(getUVRectangle(&atlas, index, 1, 6));
+        }
+    });
+
+    benchmark("ColorFromHex", [&](long iterations)
+    {
+        const char *hex = "#1a2b3cff";
+        for (long i = 0; i < iterations; i++)
+        {
+            keep(hex);
+            keep(ColorFromHex(hex));
+        }
+    });
+
+    benchmark("Normalise", [&](long iterations)
+    {
+        for (long i = 0; i < iterations; i++)
+        {
+            Vector2 vector = { 3.0f, 4.0f };
+            keep(vector);
+            Normalise(&vector);
+            keep(vector);
+        }
+    });
+
+    benchmark("GetLength", [&](long iterations)
+    {
+        for (long i = 0; i < iterations; i++)
+        {
+            Vector2 vector = { 3.0f, 4.0f };
+            keep(vector);
+            keep(GetLength(vector));
+        }
+    });
+}
+
+bool writeResults(const char *filepath)
+{
+    FILE *file = fopen(filepath, "w");
+    if (file == nullptr) return false;
+
+    for (size_t i = 0; i < gResults.size(); i++)
+        fprintf(file, "%s,%.3f,%.3f\n", gResults[i].name, gResults[i].nanoseconds, gResults[i].allocations);
+
+    return fclose(file) == 0;
+}
+
+/**
+ * Compares this run against a results file from an earlier one.
+ *
+ * @return the number of benchmarks that regressed, or -1 if the baseline
+ * couldn't be read.
+ */
+int compareWithBaseline(const char *filepath)
+{
+    FILE *file = fopen(filepath, "r");
+    if (file == nullptr) return -1;
+
+    int  regressions = 0;
+    char line[256];
+
+    printf("\nagainst %s:\n", filepath);
+
+    while (fgets(line, sizeof(line), file) != nullptr)
+    {
+        // Names can't contain commas, so the last two fields are the numbers
+        char *allocationsField = strrchr(line, ',');
+        if (allocationsField == nullptr) continue;
+        *allocationsField++ = '\0';
+
+        char *nanosecondsField = strrchr(line, ',');
+        if (nanosecondsField == nullptr) continue;
+        *nanosecondsField++ = '\0';
+
+        double nanoseconds = atof(nanosecondsField),
+               allocations = atof(allocationsField);
+
+        for (size_t i = 0; i < gResults.size(); i++)
+        {
+            if (strcmp(gResults[i].name, line) != 0) continue;
+
+            double ratio  = nanoseconds > 0.0 ? gResults[i].nanoseconds / nanoseconds : 1.0;
+            bool   slower = ratio > REGRESSION_THRESHOLD,
+                   allocating = gResults[i].allocations > allocations + 0.0005;
+
+            printf("%-36s %+8.1f%%%s%s\n", line, (ratio - 1.0) * 100.0,
+                slower ? "  SLOWER" : "", allocating ? "  MORE ALLOCATIONS" : "");
+
+            regressions += slower || allocating;
+        }
+    }
+
+    fclose(file);
+    return regressions;
+}
+
+int main(int argc, char *argv[])
+{
+    const char *csvPath      = nullptr;
+    const char *baselinePath = nullptr;
+
+    for (int i = 1; i + 1 < argc; i++)
+    {
+        if      (strcmp(argv[i], "--filter")   == 0) gFilter      = argv[++i];
+        else if (strcmp(argv[i], "--csv")      == 0) csvPath      = argv[++i];
+        else if (strcmp(argv[i], "--baseline") == 0) baselinePath = argv[++i];
+    }
+
+    if (!checkRenderCommands()) return 1;
+
+    runCollisionBenchmarks();
+    runStepBenchmarks();
+    runTerrainBenchmarks();
+    runParticleBenchmarks();
+    runRenderBenchmarks();
+    runHelperBenchmarks();
+
+    if (csvPath != nullptr && !writeResults(csvPath))
+    {
+        fprintf(stderr, "could not write %s\n", csvPath);
+        return 1;
+    }
+
+    if (baselinePath != nullptr)
+    {
+        int regressions = compareWithBaseline(baselinePath);
+        if (regressions < 0)
+        {
+            fprintf(stderr, "could not read %s\n", baselinePath);
+            return 1;
+        }
+
+        return regressions == 0 ? 0 : 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,293 @@
+/**
+* Headless lunar lander driver. Runs randomized landing episodes without a
+* window, across every core, so it can be benchmarked (and batch-run) on
+* machines with no GPU.
+*
+* Usage: ./headless_app [episodes] [seed] [landing pads] [threads] [timestep]
+*        ./headless_app --record <directory> [episodes] [seed] [landing pads]
+*        ./headless_app --replay <input log>...
+*        ./headless_app --generate-level <landing pads> <seed> <level>
+*        ./headless_app --compile-level <level> <compiled level>
+*        ./headless_app --check-batch [landers] [seed] [steps]
+*
+* With no pad count (or 0) every episode uses the stock level; otherwise each
+* episode gets a randomly generated level with that many pads. With no thread
+* count (or 0) it uses one thread per hardware thread. The timestep defaults
+* to the game's 1/60 s; collisions are swept, so several times that is safe.
+*
+* --record plays the same episodes on one thread and writes each one's inputs
+* to its own log in the directory; --replay plays logs back and reports any
+* that no longer end the way they were recorded.
+*
+* --generate-level writes a random level out as an editable text level;
+* --compile-level turns a text level into the binary form the game loads
+* without parsing (the game's --level takes either).
+*
+* --check-batch steps two copies of the same random batch of landers, one
+* through LanderBatch's vector path and one through its scalar reference, and
+* exits non-zero the first time they differ in a single bit.
+**/
+
+#include "CS3113/Rollout.h"
+#include "CS3113/InputLog.h"
+#include "CS3113/LevelFile.h"
+#include "CS3113/Level.h"
+#include "CS3113/LanderBatch.h"
+#include "CS3113/Pilot.h"
+#include "CS3113/Random.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+int record(int argc, char *argv[])
+{
+    if (argc < 3)
+    {
+        fprintf(stderr, "usage: %s --record <directory> [episodes] [seed] [landing pads]\n", argv[0]);
+        return 1;
+    }
+
+    RolloutConfig config;
+    if (argc > 3) config.episodes    = atol(argv[3]);
+    if (argc > 4) config.seed        = (unsigned int) atol(argv[4]);
+    if (argc > 5) config.landingPads = atoi(argv[5]);
+
+    Simulation    simulation;
+    InputRecorder recorder;
+    char          filepath[1024];
+
+    for (long episode = 0; episode < config.episodes; episode++)
+    {
+        RandomPilot pilot(startEpisode(config, episode, &simulation));
+        recorder.begin(simulation, config.timestep, config.landingPads,
+            mixSeed(config.seed, (unsigned int) episode));
+
+        for (int steps = 0; !simulation.isGameOver() && steps < config.maxSteps; steps++)
+        {
+            pilot.fly(&simulation, config.timestep);
+            recorder.record(simulation);
+            simulation.step(config.timestep);
+        }
+
+        snprintf(filepath, sizeof(filepath), "%s/episode-%06ld.inputs", argv[2], episode);
+        if (!recorder.save(filepath, simulation))
+        {
+            fprintf(stderr, "could not write %s\n", filepath);
+            return 1;
+        }
+    }
+
+    printf("recorded %ld episodes to %s\n", config.episodes, argv[2]);
+    return 0;
+}
+
+int replay(int argc, char *argv[])
+{
+    Simulation     simulation;
+    InputLogReader log;
+
+    long replayed = 0, mismatched = 0, unreadable = 0, steps = 0;
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (int i = 2; i < argc; i++)
+    {
+        if (!log.open(argv[i]))
+        {
+            fprintf(stderr, "not an input log: %s\n", argv[i]);
+            unreadable++;
+            continue;
+        }
+
+        if (!replayInputLog(log, &simulation))
+        {
+            printf("MISMATCH %s\n", argv[i]);
+            mismatched++;
+        }
+
+        replayed++;
+        steps += log.getStepCount();
+    }
+
+    double seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+
+    printf("replayed:            %ld\n", replayed);
+    printf("mismatched:          %ld\n", mismatched);
+    printf("unreadable:          %ld\n", unreadable);
+    printf("steps:               %ld\n", steps);
+    printf("elapsed:             %.3f s\n", seconds);
+    printf("steps/s:             %.0f\n", steps / seconds);
+
+    return mismatched == 0 && unreadable == 0 ? 0 : 1;
+}
+
+int generateLevel(int argc, char *argv[])
+{
+    if (argc < 5)
+    {
+        fprintf(stderr, "usage: %s --generate-level <landing pads> <seed> <level>\n", argv[0]);
+        return 1;
+    }
+
+    Simulation simulation;
+    loadRandomLevel(&simulation, ROCKET_STARTING_POSITION, atoi(argv[2]), (unsigned int) atol(argv[3]));
+
+    if (!writeLevelSource(simulation, argv[4]))
+    {
+        fprintf(stderr, "could not write %s\n", argv[4]);
+        return 1;
+    }
+
+    return 0;
+}
+
+int compile(int argc, char *argv[])
+{
+    if (argc < 4)
+    {
+        fprintf(stderr, "usage: %s --compile-level <level> <compiled level>\n", argv[0]);
+        return 1;
+    }
+
+    if (!compileLevel(argv[2], argv[3]))
+    {
+        fprintf(stderr, "could not compile %s to %s\n", argv[2], argv[3]);
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    Simulation    simulation;
+    CompiledLevel level;
+    if (!level.open(argv[3]))
+    {
+        fprintf(stderr, "could not read back %s\n", argv[3]);
+        return 1;
+    }
+    loadCompiledLevel(&simulation, level);
+
+    double seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+
+    printf("landing pads:        %d\n", level.getLandingPadCount());
+    printf("load time:           %.3f ms\n", seconds * 1e3);
+
+    return 0;
+}
+
+int checkBatch(int argc, char *argv[])
+{
+    int          count = argc > 2 ? atoi(argv[2]) : 100000;
+    unsigned int seed  = argc > 3 ? (unsigned int) atol(argv[3]) : 1;
+    int          steps = argc > 4 ? atoi(argv[4]) : 600;
+
+    const float deltaTime = 1.0f / 60.0f;
+
+    LanderBatch vector, scalar;
+    vector.reset(count);
+    scalar.reset(count);
+
+    // Spread over the middle of the world, some slow enough to still be in
+    // bounds at the end and some not, with a few seconds of fuel at most so
+    // plenty run dry; some start out with none at all
+    Random random(seed);
+    for (int i = 0; i < count; i++)
+    {
+        Vector2 position = { random.nextFloat(200.0f, 1300.0f), random.nextFloat(150.0f, 650.0f) },
+                velocity = { random.nextFloat(-80.0f, 80.0f),   random.nextFloat(-80.0f, 80.0f)  };
+        float   fuelTank = random.nextFloat(-0.5f, 3.0f);
+
+        vector.setLander(i, position, velocity);
+        scalar.setLander(i, position, velocity);
+        vector.setFuelTank(i, fuelTank);
+        scalar.setFuelTank(i, fuelTank);
+    }
+
+    for (int step = 0; step < steps; step++)
+    {
+        // Thrusters are held between changes, as a pilot's are, and changed
+        // now and then: up half the time or so, which roughly hovers, and
+        // sideways less often
+        for (int i = 0; i < count; i++)
+        {
+            unsigned int bits = random.next();
+            if ((bits >> 24) >= 32) continue;
+
+            bool up = (bits & 0xFF) < 140, left = (bits >> 8 & 0xFF) < 40, right = (bits >> 16 & 0xFF) < 40;
+
+            vector.setThrusters(i, up, left, right);
+            scalar.setThrusters(i, up, left, right);
+        }
+
+        vector.step(deltaTime);
+        scalar.stepScalar(deltaTime);
+
+        int mismatch = vector.findMismatch(scalar);
+        if (mismatch >= 0)
+        {
+            Vector2 a = vector.getPosition(mismatch), b = scalar.getPosition(mismatch);
+            printf("MISMATCH lander %d after step %d: %s (%.9g, %.9g) fuel %.9g, scalar (%.9g, %.9g) fuel %.9g\n",
+                mismatch, step + 1, LanderBatch::getInstructionSet(),
+                a.x, a.y, vector.getFuelTank(mismatch), b.x, b.y, scalar.getFuelTank(mismatch));
+            return 1;
+        }
+    }
+
+    long outcomes[GAME_OVER_REASON_COUNT] = {};
+    for (int i = 0; i < count; i++)
+        if (scalar.isGameOver(i)) outcomes[scalar.getGameOverReason(i)]++;
+
+    printf("instruction set:     %s\n", LanderBatch::getInstructionSet());
+    printf("landers:             %d\n", count);
+    printf("steps:               %d\n", steps);
+    printf("still flying:        %d\n", scalar.getFlyingCount());
+    printf("out of fuel:         %ld\n", outcomes[OUT_OF_FUEL]);
+    printf("out of bounds:       %ld\n", outcomes[OUT_OF_BOUNDS]);
+
+    // A check that never reached one of the ways a step can end proves
+    // nothing about it
+    if (scalar.getFlyingCount() == 0 || outcomes[OUT_OF_FUEL] == 0 || outcomes[OUT_OF_BOUNDS] == 0)
+    {
+        fprintf(stderr, "batch did not cover flying, out of fuel and out of bounds landers\n");
+        return 1;
+    }
+
+    printf("bit-identical\n");
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc > 1 && strcmp(argv[1], "--record") == 0) return record(argc, argv);
+    if (argc > 1 && strcmp(argv[1], "--replay") == 0) return replay(argc, argv);
+    if (argc > 1 && strcmp(argv[1], "--generate-level") == 0) return generateLevel(argc, argv);
+    if (argc > 1 && strcmp(argv[1], "--compile-level") == 0)  return compile(argc, argv);
+    if (argc > 1 && strcmp(argv[1], "--check-batch") == 0)    return checkBatch(argc, argv);
+
+    RolloutConfig config;
+    if (argc > 1) config.episodes    = atol(argv[1]);
+    if (argc > 2) config.seed        = (unsigned int) atol(argv[2]);
+    if (argc > 3) config.landingPads = atoi(argv[3]);
+    if (argc > 4) config.threads     = atoi(argv[4]);
+    if (argc > 5) config.timestep    = (float) atof(argv[5]);
+
+    RolloutStats stats = runRollouts(config);
+
+    printf("episodes:            %ld\n", stats.episodes);
+    printf("threads:             %d\n", stats.threads);
+    printf("steps:               %ld\n", stats.steps);
+    printf("landed successfully: %ld (%.2f%%)\n", stats.outcomes[LANDED_SUCCESSFULLY], 100.0 * stats.getRate(LANDED_SUCCESSFULLY));
+    printf("crashed:             %ld (%.2f%%)\n", stats.outcomes[CRASHED], 100.0 * stats.getRate(CRASHED));
+    printf("out of fuel:         %ld (%.2f%%)\n", stats.outcomes[OUT_OF_FUEL], 100.0 * stats.getRate(OUT_OF_FUEL));
+    printf("out of bounds:       %ld (%.2f%%)\n", stats.outcomes[OUT_OF_BOUNDS], 100.0 * stats.getRate(OUT_OF_BOUNDS));
+    printf("timed out:           %ld (%.2f%%)\n", stats.timeouts, 100.0 * stats.getTimeoutRate());
+    printf("pad contacts:        %ld\n", stats.padContacts);
+    printf("elapsed:             %.3f s\n", stats.seconds);
+    printf("episodes/s:          %.0f\n", stats.episodes / stats.seconds);
+    printf("steps/s:             %.0f\n", stats.steps / stats.seconds);
+
+    return 0;
+}
@@ -9,185 +9,828 @@
 **/
 
 #include "CS3113/Entity.h"
+#include "CS3113/Level.h"
+#include "CS3113/LevelFile.h"
+#include "CS3113/InputLog.h"
+#include "CS3113/Profiler.h"
+#include "CS3113/Hud.h"
+#include "CS3113/AssetLoader.h"
+#include "CS3113/TripleBuffer.h"
+#include "CS3113/WorldSnapshot.h"
+#include "CS3113/FramePacer.h"
+#include "CS3113/RaylibRenderBackend.h"
+
+#ifdef CHECK_ALLOCATIONS
+#include "CS3113/AllocationCounter.h"
+#include "CS3113/Pilot.h"
+#endif
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <stdio.h>
+#include <string.h>
+#include <thread>
 
 // Global Constants
 constexpr int SCREEN_WIDTH  = 1500,
               SCREEN_HEIGHT = 800,
-              FPS           = 120,
-              NUMBER_OF_LANDING_PADS = 5;
+              FPS           = 120;
 
 constexpr char BG_COLOUR[]    = "#000000ff";
+constexpr Color TERRAIN_COLOUR = { 90, 90, 96, 255 };
 constexpr Vector2 ORIGIN      = { SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2 };
 
 constexpr float FIXED_TIMESTEP = 1.0f / 60.0f;
+constexpr int   MAX_SUBSTEPS   = 8;
+constexpr int64_t STEP_NANOSECONDS = (int64_t) (FIXED_TIMESTEP * 1e9);
 
 constexpr char ROCKET_IDLE[]  = "assets/idling_rocket.png";
 constexpr char ROCKET_THRUSTING[]  = "assets/thrusting_rocket.png";
 constexpr char LANDING_PAD[] = "assets/white_landing_platform.png";
 
-Vector2 gRocketPosition = ORIGIN,
-        gRocketScale    = { (float) 100 , (float) 100 },
+// Written by `make bake`; without it the PNGs above are decoded at startup
+constexpr char BAKED_TEXTURES[] = "assets/textures.bin";
 
-        gLandingPadPosition = { ORIGIN.x - 500, ORIGIN.y + 200},
-        gLandingPadScale    = { (float) 500  , (float) 30 },
+Vector2 gRocketPosition = ORIGIN;
 
-        gRectanglePadPosition = { ORIGIN.x, ORIGIN.y + 300},
-        gRectanglePadScale    = { (float) 500 , (float) 304  };
+// --level <path> plays a level file, text or compiled, instead of the stock
+// one; the stock level is built in code if its file can't be read. Input
+// logs only record generated levels, so --record refuses any other level.
+// assets/lunar.level is the stock layout over a generated surface
+constexpr char STOCK_LEVEL_PATH[] = "assets/default.level";
+const char *gLevelPath = STOCK_LEVEL_PATH;
+
+Simulation gSimulation;
+
+// Set by --record <path>; every step's inputs are logged and written there
+// on exit
+const char   *gRecordingPath = nullptr;
+InputRecorder gInputRecorder;
+
+// F3 toggles the timings overlay and F4 writes a Chrome trace to
+// gProfilePath; --profile <path> changes the path and also writes one on exit
+const char *gProfilePath   = "profile.json";
+bool        gProfileOnExit = false;
+bool        gShowProfiler  = false;
+
+// The overlay only sees sections timed on the main thread; the simulation
+// thread's are in the trace
+constexpr const char *PROFILED_SECTIONS[] = {
+    "frame", "processInput", "update", "render", "animation", "particles",
+    "input to step", "input to display"
+};
 
 Entity *gRocket = nullptr;
-Entity *gLandingPad[NUMBER_OF_LANDING_PADS];
-Entity *gRectanglePad = nullptr;
+Texture2D gLandingPadTexture;
+
+// The level's ground, as triangles down to the bottom of the screen; built
+// once, since the terrain never changes during play
+Mesh2D gTerrainMesh;
+
+// Exhaust and crash debris, stepped and drawn on the main thread; they're
+// only for show. The pool is far bigger than the game ever fills, so nothing
+// is dropped, and it's all allocated before the first frame
+constexpr int   PARTICLE_CAPACITY = 100000;
+constexpr float PARTICLE_GRAVITY  = 60.0f;
+ParticleSystem  gParticles(PARTICLE_CAPACITY, PARTICLE_GRAVITY);
+
+// A crash throws a fan of debris up and out from where the rocket hit
+constexpr int             DEBRIS_COUNT = 600;
+constexpr ParticleEmitter DEBRIS       = {
+    { 0.0f, 0.0f }, { 0.0f, -1.0f }, 1.4f,
+    60.0f, 260.0f, 0.8f, 2.0f,
+    3.0f, { 180, 180, 190, 255 }
+};
+
+// Everything drawn in a frame is recorded here first, then sorted and handed
+// to the backend in one go
+RenderCommandList   gRenderCommands;
+RaylibRenderBackend gRenderBackend({ 0.0f, 0.0f, (float) SCREEN_WIDTH, (float) SCREEN_HEIGHT });
+
+Color gBackgroundColour;
+
+constexpr const char *GAME_OVER_MESSAGES[GAME_OVER_REASON_COUNT] = {
+    "MISSION FAILED: OUT OF BOUNDS",
+    "MISSION FAILED: OUT OF FUEL",
+    "MISSION ACCOMPLISHED: LANDED SUCCESSFULLY",
+    "MISSION FAILED: CRASHED"
+};
+
+Hud gHud;
+int gFuelLabel,
+    gAltitudeLabel,
+    gHorizontalSpeedLabel,
+    gVerticalSpeedLabel,
+    gGameOverLabels[GAME_OVER_REASON_COUNT];
+
+#ifdef CHECK_ALLOCATIONS
+// The allocation check build flies itself with the profiler overlay up, and
+// fails if any frame after the warm-up touches the heap, on either thread.
+// The simulation steps on its own clock, so the warm-up also waits for it
+// to have published a number of snapshots
+constexpr int ALLOCATION_WARMUP_FRAMES    = 120,
+              ALLOCATION_WARMUP_SNAPSHOTS = 60,
+              ALLOCATION_CHECK_FRAMES     = 1200;
+
+RandomPilot gPilot;
+int         gExitCode = 0;
+#endif
+
+// Textures are decoded in the background while a loading screen is up.
+// Time to first frame runs from launch to the end of the first frame of the
+// game proper, in milliseconds; negative until then
+AssetLoader gAssetLoader;
+int64_t     gLaunchTime       = 0;
+float       gTimeToFirstFrame = -1.0f;
+
+// The simulation steps on a thread of its own, at the fixed rate. Input
+// goes to it and snapshots of the world come back through triple buffers, so
+// neither a slow frame nor a slow step ever waits on the other. The lock is
+// only held around each batch of steps, so a trace can be written (which
+// needs the thread to stop recording) while the game runs
+struct InputSample
+{
+    bool    up;
+    bool    left;
+    bool    right;
+
+    // When the keys were read, and when a thruster key was last seen going
+    // down, for the latency figures
+    int64_t time;
+    int64_t pressTime;
+};
+
+TripleBuffer<InputSample>   gInputs;
+TripleBuffer<WorldSnapshot> gSnapshots;
+std::thread                 gSimulationThread;
+std::atomic<bool>           gIsSimulating(false);
+std::mutex                  gSimulationLock;
+int64_t                     gNextStepTime = 0;
+
+// Set when a new snapshot is picked up, so its latency is recorded once,
+// by the first frame that shows it
+bool gIsSnapshotNew   = false;
+bool gIsGameOverShown = false;
+long gSnapshotCount   = 0;
+
+// Frames are paced by gFramePacer rather than raylib, which is never given a
+// target rate. The pacer's wait comes between EndDrawing(), which polls
+// input, and processInput(), which polls again so the keys the simulation
+// gets are as fresh as they can be. raylib only reports a press on the poll
+// that saw it, so presses from both polls are gathered into these
+FramePacer  gFramePacer(FPS);
+InputSample gLastInput = {};
+bool        gIsQuitPressed     = false,
+            gIsProfilerPressed = false,
+            gIsTracePressed    = false;
+
+// Key-down to thrust, from the poll that first saw a thruster key go down to
+// the step that fired it. Simulation thread only, until it's joined
+constexpr int64_t THRUST_LATENCY_BUCKET_NANOSECONDS = 2000000;
+
+Histogram gThrustLatency(THRUST_LATENCY_BUCKET_NANOSECONDS);
+int64_t   gThrustPressTime = 0;
 
 // Global Variables
 AppStatus gAppStatus   = RUNNING;
-float gPreviousTicks   = 0.0f,
-      gAngle          = 0.0f,
-      gTimeAccumulator = 0.0f;
+float gInterpolation   = 0.0f;
 
 // Function Declarations
-void initialise();
+bool initialise(int argc, char *argv[]);
+bool loadAssets();
+void renderLoadingScreen();
+void latchKeyPresses();
 void processInput();
+void simulate();
+void stepSimulation();
 void update();
 void render();
+void buildTerrainMesh();
+void renderLandingPads();
+void handleEvents();
+void updateHud();
+void renderProfiler();
+void logHistogram(const char *title, const Histogram &histogram);
 void shutdown();
 
 
-void initialise()
+/**
+ * @return `false` if the arguments can't be honoured; nothing has been set
+ * up yet in that case. Closing the window before the textures have loaded
+ * tears down what was set up so far and leaves the app `TERMINATED`.
+ */
+bool initialise(int argc, char *argv[])
 {
+    for (int i = 1; i + 1 < argc; i++)
+    {
+        if (strcmp(argv[i], "--record") == 0) gRecordingPath = argv[i + 1];
+        if (strcmp(argv[i], "--level") == 0)  gLevelPath     = argv[i + 1];
+        if (strcmp(argv[i], "--profile") == 0)
+        {
+            gProfilePath   = argv[i + 1];
+            gProfileOnExit = true;
+        }
+    }
+
+    // A log of any other level would replay against the stock one and fail
+    if (gRecordingPath != nullptr && strcmp(gLevelPath, STOCK_LEVEL_PATH) != 0)
+    {
+        fprintf(stderr, "--record only records the stock level, not %s\n", gLevelPath);
+        return false;
+    }
+
     InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "Lunar Lander");
 
+    // Decoding starts first so it overlaps the rest of the set-up
+    gAssetLoader.openBaked(BAKED_TEXTURES);
+    gAssetLoader.request(ROCKET_IDLE);
+    gAssetLoader.request(ROCKET_THRUSTING);
+    gAssetLoader.request(LANDING_PAD);
+    gAssetLoader.start();
+
     std::map<RocketState, std::vector<int>> animationAtlas = {
         {IDLE,          {  0, 1, 2, 3, 4, 5      }},
         {THRUSTING,     {  0, 1, 2, 3, 4, 5      }},
     };
 
-    SetTargetFPS(FPS);
+    gFramePacer.start();
+
+    gBackgroundColour = ColorFromHex(BG_COLOUR);
+
+    gHud.load(SCREEN_WIDTH, SCREEN_HEIGHT);
+    gFuelLabel            = gHud.addLabel(20, 20, 20, WHITE);
+    gAltitudeLabel        = gHud.addLabel(SCREEN_WIDTH - 300, 20, 20, WHITE);
+    gHorizontalSpeedLabel = gHud.addLabel(SCREEN_WIDTH - 300, 50, 20, WHITE);
+    gVerticalSpeedLabel   = gHud.addLabel(SCREEN_WIDTH - 300, 80, 20, WHITE);
+
+    gGameOverLabels[OUT_OF_BOUNDS]       = gHud.addLabel(SCREEN_WIDTH / 2 - 450, SCREEN_HEIGHT / 2, 50, RED);
+    gGameOverLabels[OUT_OF_FUEL]         = gHud.addLabel(SCREEN_WIDTH / 2 - 350, SCREEN_HEIGHT / 2, 50, RED);
+    gGameOverLabels[CRASHED]             = gHud.addLabel(SCREEN_WIDTH / 2 - 350, SCREEN_HEIGHT / 2, 50, RED);
+    gGameOverLabels[LANDED_SUCCESSFULLY] = gHud.addLabel(SCREEN_WIDTH / 2 - 650, SCREEN_HEIGHT / 2, 50, GREEN);
+
+    if (loadLevelFile(&gSimulation, gLevelPath)) gRocketPosition = gSimulation.getRocketPosition();
+    else                                         loadDefaultLevel(&gSimulation, gRocketPosition);
+
+    if (gRecordingPath != nullptr) gInputRecorder.begin(gSimulation, FIXED_TIMESTEP);
+
+    buildTerrainMesh();
+
+    // Everything below finds its textures already in the cache
+    if (!loadAssets())
+    {
+        gAppStatus = TERMINATED;
+        gAssetLoader.release();
+        gHud.unload();
+        CloseWindow();
+        return true;
+    }
 
     gRocket = new Entity(
         gRocketPosition, 
-        gRocketScale, 
+        ROCKET_SCALE, 
         { ROCKET_IDLE, ROCKET_THRUSTING },
         ATLAS, 
         { 1, 6 },
         animationAtlas,
         ROCKET
     );
+    gRocket->setColliderDimensions(ROCKET_COLLIDER);
+    gRocket->setExhaust(&gParticles);
 
-    gLandingPad[0] = new Entity(
-        gLandingPadPosition,
-        gLandingPadScale,
-        LANDING_PAD,
-        FIXED_LANDING_PAD
-    );
+    // Every pad shares one sprite, stretched over its collider
+    gLandingPadTexture = TextureCache::acquire(LANDING_PAD);
 
-    gLandingPad[1] = new Entity(
-        {gLandingPadPosition.x + 500, gLandingPadPosition.y},
-        gLandingPadScale,
-        LANDING_PAD,
-        MOVING_LANDING_PAD
-    );
+    // Every slot starts out as the level as loaded, so there's something to
+    // draw before the first step lands
+    int64_t now = Profiler::now();
+    for (int i = 0; i < TripleBuffer<WorldSnapshot>::SLOT_COUNT; i++)
+    {
+        WorldSnapshot &snapshot = gSnapshots.getSlots()[i];
+        snapshot.reserve(gSimulation);
+        snapshot.capture(gSimulation);
+        snapshot.stepTime = snapshot.inputTime = snapshot.steppedTime = now;
 
-    gLandingPad[2] = new Entity(
-        {gLandingPadPosition.x + 1000, gLandingPadPosition.y},
-        gLandingPadScale,
-        LANDING_PAD,
-        FIXED_LANDING_PAD
-    );
+        gInputs.getSlots()[i] = { false, false, false, now, 0 };
+    }
 
-    gLandingPad[3] = new Entity(
-        {gLandingPadPosition.x, gLandingPadPosition.y - 400},
-        gLandingPadScale,
-        LANDING_PAD,
-        FIXED_LANDING_PAD
-    );
+    gNextStepTime = now + STEP_NANOSECONDS;
+    gIsSimulating = true;
+    gSimulationThread = std::thread(simulate);
 
-    gLandingPad[4] = new Entity(
-        {gLandingPadPosition.x + 1000, gLandingPadPosition.y - 300},
-        gLandingPadScale,
-        LANDING_PAD,
-        FIXED_LANDING_PAD
-    );
+    return true;
+}
 
-    gRocket->setColliderDimensions({ gRocketScale.x/2, gRocketScale.y/2});
-    gRocket->setAcceleration({ 0.0f, GRAVITATIONAL_ACCELERATION });
-    for (int i = 0; i < NUMBER_OF_LANDING_PADS; i++) gLandingPad[i]->setColliderDimensions({ gLandingPadScale.x, gLandingPadScale.y});
+/**
+ * Shows the loading screen until every texture is on the GPU, uploading
+ * each one as soon as a worker has decoded it.
+ *
+ * @return `false` if the window was closed first.
+ */
+bool loadAssets()
+{
+    while (!gAssetLoader.isDone())
+    {
+        if (WindowShouldClose()) return false;
 
-    SetTargetFPS(FPS);
+        gAssetLoader.uploadReady();
+        renderLoadingScreen();
+        gFramePacer.wait();
+    }
+
+    return true;
 }
 
-void processInput() 
+void renderLoadingScreen()
 {
+    constexpr int BAR_WIDTH = 400, BAR_HEIGHT = 8;
 
-    if (IsKeyPressed(KEY_Q) || WindowShouldClose()) gAppStatus = TERMINATED;
+    constexpr float BAR_LEFT = ORIGIN.x - BAR_WIDTH / 2;
 
-    if      (IsKeyDown(KEY_A))  gRocket->accelerateLeft();
-    if      (IsKeyDown(KEY_D))  gRocket->accelerateRight();
-    if      (IsKeyDown(KEY_W))  gRocket->accelerateUp();
+    gRenderCommands.clear();
+    gRenderCommands.drawText(LAYER_OVERLAY, "LOADING", BAR_LEFT, ORIGIN.y - 40, 20, WHITE);
+    gRenderCommands.drawRectangleLines(LAYER_OVERLAY, { BAR_LEFT, ORIGIN.y, BAR_WIDTH, BAR_HEIGHT }, WHITE);
+    gRenderCommands.drawRectangle(LAYER_OVERLAY,
+        { BAR_LEFT, ORIGIN.y, BAR_WIDTH * gAssetLoader.getProgress(), BAR_HEIGHT }, WHITE);
+
+    BeginDrawing();
+    ClearBackground(gBackgroundColour);
+    gRenderBackend.submit(gRenderCommands);
+    EndDrawing();
+}
 
+void latchKeyPresses()
+{
+    gIsQuitPressed     |= IsKeyPressed(KEY_Q);
+    gIsProfilerPressed |= IsKeyPressed(KEY_F3);
+    gIsTracePressed    |= IsKeyPressed(KEY_F4);
 }
 
-void update() 
+void processInput() 
 {
-    // Delta time
-    float ticks = (float) GetTime();
-    float deltaTime = ticks - gPreviousTicks;
-    gPreviousTicks  = ticks;
+    PROFILE_SCOPE("processInput");
 
+    // Presses from EndDrawing()'s poll have to be taken before polling again
+    latchKeyPresses();
+    PollInputEvents();
+    latchKeyPresses();
 
-    // Fixed timestep
-    deltaTime += gTimeAccumulator;
+    if (gIsQuitPressed || WindowShouldClose()) gAppStatus = TERMINATED;
 
-    if (deltaTime < FIXED_TIMESTEP)
+    if (gIsProfilerPressed) gShowProfiler = !gShowProfiler;
+    if (gIsTracePressed)
     {
-        gTimeAccumulator = deltaTime;
-        return;
+        std::lock_guard<std::mutex> guard(gSimulationLock);
+        if (!Profiler::writeChromeTrace(gProfilePath))
+            TraceLog(LOG_WARNING, "Could not write profile to %s", gProfilePath);
     }
 
-    while (deltaTime >= FIXED_TIMESTEP)
+    gIsQuitPressed = gIsProfilerPressed = gIsTracePressed = false;
+
+    InputSample input;
+    input.up        = IsKeyDown(KEY_W);
+    input.left      = IsKeyDown(KEY_A);
+    input.right     = IsKeyDown(KEY_D);
+    input.time      = Profiler::now();
+    input.pressTime = gLastInput.pressTime;
+
+    if ((input.up && !gLastInput.up) || (input.left && !gLastInput.left) ||
+        (input.right && !gLastInput.right)) input.pressTime = input.time;
+
+    gLastInput = input;
+    gInputs.getWriteSlot() = input;
+    gInputs.publish();
+}
+
+/**
+ * The simulation thread: runs whatever steps have come due, then sleeps
+ * until the next one is.
+ */
+void simulate()
+{
+    while (gIsSimulating.load(std::memory_order_acquire))
     {
-        // Update game here and call use FIXED_TIMESTEP for any calls
-        deltaTime -= FIXED_TIMESTEP;
+        {
+            std::lock_guard<std::mutex> guard(gSimulationLock);
+            stepSimulation();
+        }
+
+        std::this_thread::sleep_for(std::chrono::nanoseconds(gNextStepTime - Profiler::now()));
     }
+}
+
+/**
+ * Runs every step due by now with the newest input, then publishes a
+ * snapshot of where they left the world. Simulation thread only.
+ */
+void stepSimulation()
+{
+    PROFILE_SCOPE("stepSimulation");
+
+    gInputs.acquire();
+    const InputSample &input = gInputs.getReadSlot();
+
+    int64_t now = Profiler::now();
+
+    int substeps = 0;
+    while (gNextStepTime <= now && substeps < MAX_SUBSTEPS)
+    {
+#ifdef CHECK_ALLOCATIONS
+        gPilot.fly(&gSimulation, FIXED_TIMESTEP);
+#else
+        gSimulation.releaseThrusters();
+        if      (input.left)   gSimulation.accelerateLeft();
+        if      (input.right)  gSimulation.accelerateRight();
+        if      (input.up)     gSimulation.accelerateUp();
+
+        if (input.pressTime != gThrustPressTime && !gSimulation.isGameOver())
+        {
+            gThrustLatency.add(Profiler::now() - input.pressTime);
+            gThrustPressTime = input.pressTime;
+        }
+#endif
+
+        if (gRecordingPath != nullptr && !gSimulation.isGameOver())
+            gInputRecorder.record(gSimulation);
+
+        gSimulation.step(FIXED_TIMESTEP);
+
+        gNextStepTime += STEP_NANOSECONDS;
+        substeps++;
+    }
+
+    if (substeps == 0) return;
+
+    // If we still owe whole steps after the cap, the simulation can't keep up
+    // with real time (or we were stalled); drop the backlog rather than
+    // letting it snowball into ever longer batches.
+    if (gNextStepTime <= now)
+        gNextStepTime += ((now - gNextStepTime) / STEP_NANOSECONDS + 1) * STEP_NANOSECONDS;
+
+    WorldSnapshot &snapshot = gSnapshots.getWriteSlot();
+    snapshot.capture(gSimulation);
+    snapshot.stepTime    = gNextStepTime - STEP_NANOSECONDS;
+    snapshot.inputTime   = input.time;
+    snapshot.steppedTime = now;
+    gSnapshots.publish();
+}
 
-    for (int i = 0; i < NUMBER_OF_LANDING_PADS; i++) {
-        gLandingPad[i]->update(FIXED_TIMESTEP);
-    }   
+/**
+ * Picks up the newest snapshot, if there is one, and moves what only the
+ * display has (the rocket's animation and where it's drawn) on to now.
+ */
+void update() 
+{
+    PROFILE_SCOPE("update");
 
-    if (gRocket != nullptr) {
-        gRocket->update(FIXED_TIMESTEP, gLandingPad, NUMBER_OF_LANDING_PADS);
+    float deltaTime = gFramePacer.getFrameSeconds();
+
+    if (gSnapshots.acquire())
+    {
+        gIsSnapshotNew = true;
+        gSnapshotCount++;
+        handleEvents();
     }
-    
 
+    const WorldSnapshot &snapshot = gSnapshots.getReadSlot();
+
+    // Everything is drawn between the last two simulated states, by however
+    // far we are into the next step
+    gInterpolation = (Profiler::now() - snapshot.stepTime) / (float) STEP_NANOSECONDS;
+    if (gInterpolation > 1.0f) gInterpolation = 1.0f;
+    if (gInterpolation < 0.0f) gInterpolation = 0.0f;
+
+    // Positioned first, so exhaust comes out of where the rocket is drawn
+    gRocket->setPosition(Vector2Lerp(
+        snapshot.rocketPreviousPosition,
+        snapshot.rocketPosition,
+        gInterpolation
+    ));
+
+    if (!snapshot.isGameOver) {
+        gRocket->setRocketState(snapshot.isThrusting ? THRUSTING : IDLE);
+        gRocket->setThrusters(snapshot.isThrustingUp, snapshot.isThrustingLeft, snapshot.isThrustingRight);
+        gRocket->update(deltaTime);
+    }
+
+    {
+        PROFILE_SCOPE("particles");
+        gParticles.update(deltaTime);
+    }
 }
 
 void render()
 {
-    BeginDrawing();
-    ClearBackground(ColorFromHex(BG_COLOUR));
+    PROFILE_SCOPE("render");
+
+    // The HUD has to be re-rasterised (if at all) outside of the frame
+    updateHud();
+    gHud.refresh();
 
-    for (int i = 0; i < NUMBER_OF_LANDING_PADS; i++) gLandingPad[i]->render();
-   
-    gRocket->render();
+    gRenderCommands.clear();
+
+    if (!gTerrainMesh.vertices.empty())
+        gRenderCommands.drawMesh(LAYER_TERRAIN, &gTerrainMesh, TERRAIN_COLOUR);
+
+    renderLandingPads();
+    if (gParticles.size() > 0) gRenderCommands.drawParticles(LAYER_PARTICLES, &gParticles);
+    gRocket->render(&gRenderCommands);
+
+    gHud.draw(&gRenderCommands);
+    if (gShowProfiler) renderProfiler();
+
+    gRenderCommands.sort();
+
+    BeginDrawing();
+    ClearBackground(gBackgroundColour);
+    gRenderBackend.submit(gRenderCommands);
     EndDrawing();
+
+    if (gTimeToFirstFrame < 0.0f)
+    {
+        gTimeToFirstFrame = (Profiler::now() - gLaunchTime) / 1e6f;
+        TraceLog(LOG_INFO, "Time to first frame: %.1f ms", gTimeToFirstFrame);
+    }
+
+#ifdef ENABLE_PROFILER
+    // From the keys being read to the frame showing their effect, split at
+    // the step that used them
+    if (gIsSnapshotNew)
+    {
+        const WorldSnapshot &snapshot = gSnapshots.getReadSlot();
+        Profiler::record("input to step",    snapshot.inputTime, snapshot.steppedTime);
+        Profiler::record("input to display", snapshot.inputTime, Profiler::now());
+    }
+#endif
+    gIsSnapshotNew = false;
+}
+
+/**
+ * Turns the terrain into a strip of quads, one per pair of neighbouring
+ * samples, each from the surface down to the bottom of the screen.
+ */
+void buildTerrainMesh()
+{
+    const Terrain &terrain = gSimulation.getTerrain();
+    gTerrainMesh.vertices.clear();
+
+    if (terrain.isEmpty()) return;
+
+    const float *heights = terrain.getHeights();
+    gTerrainMesh.vertices.reserve((terrain.getSampleCount() - 1) * 6);
+
+    for (int i = 0; i + 1 < terrain.getSampleCount(); i++)
+    {
+        float left  = terrain.getMinX() + i * terrain.getSpacing(),
+              right = left + terrain.getSpacing();
+
+        Vector2 topLeft     = { left,  heights[i]            },
+                bottomLeft  = { left,  (float) SCREEN_HEIGHT },
+                bottomRight = { right, (float) SCREEN_HEIGHT },
+                topRight    = { right, heights[i + 1]        };
+
+        gTerrainMesh.vertices.push_back(topLeft);
+        gTerrainMesh.vertices.push_back(bottomLeft);
+        gTerrainMesh.vertices.push_back(bottomRight);
+
+        gTerrainMesh.vertices.push_back(topLeft);
+        gTerrainMesh.vertices.push_back(bottomRight);
+        gTerrainMesh.vertices.push_back(topRight);
+    }
+}
+
+void renderLandingPads()
+{
+    // The layout is never written during play, so it's safe to read from the
+    // world; only moving pads' positions come from the snapshot
+    const EntityWorld   &world    = gSimulation.getWorld();
+    const WorldSnapshot &snapshot = gSnapshots.getReadSlot();
+
+    Rectangle textureArea = {
+        0.0f, 0.0f,
+        static_cast<float>(gLandingPadTexture.width),
+        static_cast<float>(gLandingPadTexture.height)
+    };
+
+    // Fixed pads are drawn where they are; moving ones are drawn after,
+    // between their last two positions
+    for (int i = ROCKET_HANDLE + 1; i < world.size(); i++)
+    {
+        if (world.entityType[i] == MOVING_LANDING_PAD) continue;
+
+        float width  = world.colliderWidth[i];
+        float height = world.colliderHeight[i];
+
+        gRenderCommands.drawSprite(
+            LAYER_LEVEL, gLandingPadTexture,
+            textureArea, { world.positionX[i], world.positionY[i], width, height },
+            { width / 2.0f, height / 2.0f },
+            0.0f, WHITE
+        );
+    }
+
+    const MovingPads &movingPads = world.movingPads;
+
+    for (int i = 0; i < movingPads.size(); i++)
+    {
+        EntityHandle pad = movingPads.handle[i];
+
+        float width  = world.colliderWidth[pad];
+        float height = world.colliderHeight[pad];
+
+        Rectangle destinationArea = {
+            snapshot.movingPadPreviousX[i] + (snapshot.movingPadX[i] - snapshot.movingPadPreviousX[i]) * gInterpolation,
+            world.positionY[pad],
+            width,
+            height
+        };
+
+        gRenderCommands.drawSprite(
+            LAYER_LEVEL, gLandingPadTexture,
+            textureArea, destinationArea, { width / 2.0f, height / 2.0f },
+            0.0f, WHITE
+        );
+    }
+}
+
+void updateHud()
+{
+    const WorldSnapshot &snapshot = gSnapshots.getReadSlot();
+    Vector2 position = snapshot.rocketPosition;
+    Vector2 velocity = snapshot.rocketVelocity;
+
+    gHud.setText(gFuelLabel,            "Fuel: %04.2f%%", snapshot.fuelTank);
+    gHud.setText(gAltitudeLabel,        "Altitude: %08.2f", SCREEN_HEIGHT - position.y);
+    gHud.setText(gHorizontalSpeedLabel, "Horizontal Speed: %08.2f", velocity.x);
+    gHud.setText(gVerticalSpeedLabel,   "Vertical Speed: %08.2f", velocity.y);
+
+}
+
+/**
+ * Reacts to what the newest snapshot shows has happened. Snapshots the
+ * renderer is too slow for are dropped, and per-step events would go with
+ * them, so the game ending is read from the snapshot's sticky flag instead.
+ * The game-over banner is only ever set here, once, when the game ends.
+ */
+void handleEvents()
+{
+    const WorldSnapshot &snapshot = gSnapshots.getReadSlot();
+    if (!snapshot.isGameOver || gIsGameOverShown) return;
+
+    gHud.setText(gGameOverLabels[snapshot.gameOverReason], "%s", GAME_OVER_MESSAGES[snapshot.gameOverReason]);
+    gIsGameOverShown = true;
+
+    if (snapshot.gameOverReason == CRASHED)
+    {
+        ParticleEmitter debris = DEBRIS;
+        debris.position = snapshot.rocketPosition;
+        gParticles.emit(debris, DEBRIS_COUNT);
+    }
+}
+
+void renderProfiler()
+{
+    char startup[48];
+    snprintf(startup, sizeof(startup), "time to first frame %.1f ms", gTimeToFirstFrame);
+    gRenderCommands.drawText(LAYER_OVERLAY, startup, 20, 40, 16, YELLOW);
+
+#ifdef ENABLE_PROFILER
+    int y = 60;
+    for (const char *section : PROFILED_SECTIONS)
+    {
+        Profiler::SectionStats stats = Profiler::getSectionStats(section);
+
+        char line[64];
+        snprintf(line, sizeof(line), "%-18s p50 %6.3f ms  p99 %6.3f ms",
+            section, stats.p50, stats.p99);
+
+        gRenderCommands.drawText(LAYER_OVERLAY, line, 20, y, 16, YELLOW);
+        y += 20;
+    }
+#else
+    gRenderCommands.drawText(LAYER_OVERLAY, "Profiler compiled out (build with -DENABLE_PROFILER)", 20, 60, 16, YELLOW);
+#endif
+}
+
+/**
+ * Logs every non-empty bucket of a histogram, one line each.
+ */
+void logHistogram(const char *title, const Histogram &histogram)
+{
+    if (histogram.getCount() == 0) return;
+
+    TraceLog(LOG_INFO, "%s: %ld samples, max %.2f ms", title, histogram.getCount(),
+        histogram.getMaximum() / 1e6);
+
+    double width = histogram.getBucketWidth() / 1e6;
+
+    for (int i = 0; i < Histogram::BUCKET_COUNT; i++)
+    {
+        long count = histogram.getBucket(i);
+        if (count == 0) continue;
+
+        double share = 100.0 * count / histogram.getCount();
+
+        if (i < Histogram::BUCKET_COUNT - 1)
+            TraceLog(LOG_INFO, "    %6.2f - %6.2f ms  %8ld  %5.1f%%", i * width, (i + 1) * width, count, share);
+        else
+            TraceLog(LOG_INFO, "    %6.2f ms and up   %8ld  %5.1f%%", i * width, count, share);
+    }
 }
 
 void shutdown() 
 { 
+    gIsSimulating = false;
+    if (gSimulationThread.joinable()) gSimulationThread.join();
+
+#ifdef ENABLE_PROFILER
+    Profiler::SectionStats latency = Profiler::getSectionStats("input to display");
+    if (latency.count > 0)
+        TraceLog(LOG_INFO, "Input to display latency: p50 %.1f ms, p99 %.1f ms", latency.p50, latency.p99);
+#endif
+
+    logHistogram("Frame lateness", gFramePacer.getLateness());
+    TraceLog(LOG_INFO, "Frames missed outright: %ld", gFramePacer.getMissedCount());
+    logHistogram("Key-down to thrust latency", gThrustLatency);
+
+    delete gRocket;
+    TextureCache::release(gLandingPadTexture);
+    gAssetLoader.release();
+    gHud.unload();
+
+    if (gProfileOnExit && !Profiler::writeChromeTrace(gProfilePath))
+        TraceLog(LOG_WARNING, "Could not write profile to %s", gProfilePath);
+
+    if (gRecordingPath != nullptr && !gInputRecorder.save(gRecordingPath, gSimulation))
+        TraceLog(LOG_WARNING, "Could not write input log to %s", gRecordingPath);
+
     CloseWindow();
 }
 
-int main(void)
+int main(int argc, char *argv[])
 {
-    initialise();
+    gLaunchTime = Profiler::now();
+
+    if (!initialise(argc, argv)) return 1;
+    if (gAppStatus == TERMINATED) return 0;
+
+#ifdef CHECK_ALLOCATIONS
+    gShowProfiler = true;
+
+    int warmupFrame = -1;
+
+    for (int frame = 0; frame < ALLOCATION_CHECK_FRAMES && gAppStatus == RUNNING; frame++)
+    {
+        long allocationsBefore = getAllocationCount();
+
+        {
+            PROFILE_SCOPE("frame");
+
+            processInput();
+            update();
+            render();
+        }
+
+        gFramePacer.wait();
+
+        if (warmupFrame < 0 && frame >= ALLOCATION_WARMUP_FRAMES &&
+            gSnapshotCount >= ALLOCATION_WARMUP_SNAPSHOTS) warmupFrame = frame;
 
+        long allocations = getAllocationCount() - allocationsBefore;
+        if (warmupFrame >= 0 && frame > warmupFrame && allocations != 0)
+        {
+            TraceLog(LOG_ERROR, "Frame %d made %ld heap allocations", frame, allocations);
+            gExitCode = 1;
+        }
+    }
+
+    if (warmupFrame < 0)
+    {
+        TraceLog(LOG_ERROR, "The simulation never warmed up");
+        gExitCode = 1;
+    }
+
+    if (gExitCode == 0) TraceLog(LOG_INFO, "No frame allocated after the first %d", warmupFrame + 1);
+
+    shutdown();
+
+    return gExitCode;
+#else
     while (gAppStatus == RUNNING)
     {
-        processInput();
-        update();
-        render();
+        {
+            PROFILE_SCOPE("frame");
+
+            processInput();
+            update();
+            render();
+        }
+
+        gFramePacer.wait();
     }
 
     shutdown();
 
     return 0;
+#endif
 }
\ No newline at end of file